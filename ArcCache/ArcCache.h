@@ -1,93 +1,1055 @@
 #pragma once
 
 #include "../CachePolicy.h"
-#include "ArcLruPart.h"
-#include "ArcLfuPart.h"
+#include "ArcGhostList.h"
+#include "../CacheStats.h"
+#include "../CacheUtils.h"
+#include "../MissRatioCurve.h"
+#include "../TimerWheel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
-namespace Cache 
+namespace Cache
 {
 
+// 自适应替换缓存：每个key只在T1/T2/B1/B2四个链表之一中出现，缓存中的key只有一个节点和一个索引项，所有调整都在同一把锁内完成
+// T1: 最近访问部分(LRU)，新条目进入T1，访问次数达到转换门槛后整体移入T2
+// T2: 高频访问部分(O(1) LFU)，同频率的节点串成频率桶，频率桶按频率从小到大串成双向链表
+// B1/B2: T1/T2被驱逐条目的幽灵链表，只保留key的指纹和权重(节点连同value在驱逐时释放)，命中时调整T1的目标容量p：
+//        命中B1说明T1偏小，p增大；命中B2说明T2偏小，p减小。驱逐时T1超出p则驱逐T1，否则驱逐T2
+// 传入weigher时容量按字节计算，p和幽灵链表同样按权重记账，调整步长为命中幽灵条目的权重
+// 支持按条目和默认TTL：过期的条目立即按未命中处理，由时间轮在后续的操作中回收，不进入幽灵链表
+// ArcMode::Canonical 为Megiddo与Modha论文中的原始ARC，见ArcMode的说明
+
+// ARC的运行模式
+enum class ArcMode
+{
+    // 默认：T1中访问次数达到转换门槛后移入T2，T2按访问频率(LFU)驱逐，幽灵命中时p按该条目的权重调整
+    Adaptive,
+    // 原始ARC：再次访问即移入T2，T2按最近访问(LRU)驱逐，不需要转换门槛；
+    // 命中B1时p增大 max(1, |B2|/|B1|)，命中B2时p减小 max(1, |B1|/|B2|)(按权重时再乘以条目权重)，
+    // 幽灵命中的key直接进入T2，并限制 |T1|+|B1| <= c、|T1|+|T2|+|B1|+|B2| <= 2c；
+    // 只有写入(put)才算一次ARC请求，读未命中不检查幽灵链表，避免"读未命中后写入"被计两次
+    Canonical
+};
+
+// ARC各部分的当前状态，用于观察自适应过程
+struct ArcStats
+{
+    size_t target = 0;   // T1的目标容量p
+    size_t capacity = 0; // p的上限(c)
+    size_t t1Weight = 0;
+    size_t t2Weight = 0;
+    size_t b1Weight = 0;
+    size_t b2Weight = 0;
+    size_t b1Size = 0;   // B1中的指纹数
+    size_t b2Size = 0;   // B2中的指纹数
+
+    // 合并多个分片的状态(各项相加)
+    ArcStats& operator+=(const ArcStats& other)
+    {
+        target += other.target;
+        capacity += other.capacity;
+        t1Weight += other.t1Weight;
+        t2Weight += other.t2Weight;
+        b1Weight += other.b1Weight;
+        b2Weight += other.b2Weight;
+        b1Size += other.b1Size;
+        b2Size += other.b2Size;
+        return *this;
+    }
+};
+
 template<typename Key, typename Value>
-class ArcCache : public CachePolicy<Key, Value> 
+class ArcCache : public CachePolicy<Key, Value>
 {
+private:
+    struct FreqBucket;
+
+    // 条目当前所在的链表
+    enum class Where : uint8_t
+    {
+        T1,
+        T2
+    };
+
+    // 未命中时key所在的幽灵链表
+    enum class Ghost : uint8_t
+    {
+        None,
+        B1,
+        B2
+    };
+
+    struct Node : TimerLink
+    {
+        template<typename... Args>
+        explicit Node(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...) {}
+
+        Key         key;
+        Value       value;
+        size_t      charge = 1;         // 计入的权重，驱逐时随指纹记入幽灵链表
+        uint64_t    expireAt = 0;       // 过期时刻(CoarseClock毫秒)，0表示永不过期，非0时节点挂在时间轮上
+        Node*       pre = nullptr;      // 所在链表(或频率桶)中的上一节点
+        Node*       next = nullptr;     // 所在链表(或频率桶)中的下一节点
+        FreqBucket* bucket = nullptr;   // 在T2中时所在的频率桶
+        uint32_t    accessCount = 1;    // 在T1中的访问次数
+        Where       where = Where::T1;
+    };
+
+    // 频率桶：桶内按进入的先后排列，队首最早进入，最先被驱逐
+    struct FreqBucket
+    {
+        explicit FreqBucket(size_t f) : freq(f) {}
+
+        size_t      freq;
+        Node*       head = nullptr;
+        Node*       tail = nullptr;
+        FreqBucket* pre = nullptr;      // 频率更小的桶
+        FreqBucket* next = nullptr;     // 频率更大的桶
+    };
+
+    // T1(原始ARC模式下还有T2)：队首最久未访问，队尾最近
+    struct NodeList
+    {
+        Node*  head = nullptr;
+        Node*  tail = nullptr;
+        size_t weight = 0;
+    };
+
 public:
-    explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2)
+    using NodeMap = std::unordered_map<Key, Node*>;
+
+    // 每个条目的固定开销估算：池中的节点 + 索引节点(频率桶数量远少于条目数，忽略)
+    static constexpr size_t kEntryOverhead = sizeof(Node) + detail::hashNodeBytes<Key, Node*>();
+
+    // mode为Canonical时transformThreshold不起作用
+    explicit ArcCache(size_t capacity = 10, size_t transformThreshold = 2, ArcMode mode = ArcMode::Adaptive)
+        : ArcCache(capacity, nullptr, transformThreshold, mode, 0)
+    {}
+
+    // 按字节限制容量：T1与T2合计不超过maxWeight字节，B1/B2各自最多记录maxWeight字节的被驱逐条目
+    ArcCache(size_t maxWeight, Weigher<Key, Value> weigher, size_t transformThreshold = 2,
+             ArcMode mode = ArcMode::Adaptive)
+        : ArcCache(maxWeight, std::move(weigher), transformThreshold, mode, 0)
+    {}
+
+    ~ArcCache() override
+    {
+        // 对象池不析构存活的对象，逐个归还
+        for (auto& entry : index_) nodePool_.destroy(entry.second);
+        while (freqHead_)
+        {
+            FreqBucket* bucket = freqHead_;
+            freqHead_ = bucket->next;
+            bucketPool_.destroy(bucket);
+        }
+    }
+
+    ArcCache(const ArcCache&) = delete;
+    ArcCache& operator=(const ArcCache&) = delete;
+
+    void put(const Key& key, const Value& value) override
+    {
+        putImpl(key, value, defaultExpireAt());
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        putImpl(key, std::move(value), defaultExpireAt());
+    }
+
+    // 写入并指定该条目的TTL，ttl不大于0表示永不过期
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
+    {
+        putImpl(key, std::forward<V>(value), CoarseClock::expireAt(ttl));
+    }
+
+    // 之后写入的条目默认的TTL，不大于0表示永不过期(默认)
+    void setDefaultTtl(std::chrono::milliseconds ttl)
+    {
+        defaultTtlMs_.store(ttl.count(), std::memory_order_relaxed);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        get(key, value);
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中时在锁内以只读引用调用visitor
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        return visitLocked(key, visitor);
+    }
+
+    // 批量读取：整批只加一次锁，逐个按visit的规则处理 | 返回命中个数
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found) override
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        return visitBatch(keys.size(),
+                          [&keys](size_t i) -> const Key& { return keys[i]; },
+                          [&](size_t i, const Value& v) { values[i] = v; found[i] = true; });
+    }
+
+    // 批量写入：整批只加一次锁，逐个按put的规则处理
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values) override
+    {
+        putBatch(std::min(keys.size(), values.size()),
+                 [&keys](size_t i) -> const Key& { return keys[i]; },
+                 [&values](size_t i) -> const Value& { return values[i]; });
+    }
+
+    // 批量访问的通用形式(分片缓存按分片分组后调用)：count个key由keyAt(i)给出，
+    // 整批只加一次锁，命中时调用visitor(i, value) | 返回命中个数
+    template<typename KeyAt, typename Visitor>
+    size_t visitBatch(size_t count, KeyAt&& keyAt, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        size_t hits = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (visitLocked(keyAt(i), [&](const Value& v) { visitor(i, v); }))
+                ++hits;
+        }
+        return hits;
+    }
+
+    // 批量写入的通用形式：第i个条目为(keyAt(i), valueAt(i))，整批只加一次锁
+    template<typename KeyAt, typename ValueAt>
+    void putBatch(size_t count, KeyAt&& keyAt, ValueAt&& valueAt)
+    {
+        if (capacity_ == 0) return;
+
+        uint64_t expireAt = defaultExpireAt();
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        for (size_t i = 0; i < count; ++i)
+        {
+            putLocked(keyAt(i), valueAt(i), expireAt);
+        }
+    }
+
+    // T1与T2的总权重(不含幽灵链表)：未设weigher时等于条目数
+    size_t weight()
+    {
+        auto lock = stats_.lock(mutex_);
+        return budget_.weight();
+    }
+
+    // 缓存中的条目数(不含幽灵链表)
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        return residentCount_;
+    }
+
+    // 当前T1的目标容量p(共享目标时为各分片的平均值)
+    size_t target()
+    {
+        auto lock = stats_.lock(mutex_);
+        return currentTarget();
+    }
+
+    // 命中B1/B2计为ghostHits(原始ARC模式下只有写入会检查幽灵链表)
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+    // p与T1/T2/B1/B2的当前状态
+    ArcStats arcStats()
+    {
+        auto lock = stats_.lock(mutex_);
+        ArcStats stats;
+        stats.target = currentTarget();
+        stats.capacity = arcCapacity_;
+        stats.t1Weight = t1_.weight;
+        stats.t2Weight = budget_.weight() - t1_.weight;
+        stats.b1Weight = b1_.weight();
+        stats.b2Weight = b2_.weight();
+        stats.b1Size = b1_.size();
+        stats.b2Size = b2_.size();
+        return stats;
+    }
+
+    ArcMode mode() const { return mode_; }
+
+    // 与其他分片共享一个全局总权重(分片缓存使用)，需在写入任何数据之前调用
+    // shareCapacity是本分片名义上分到的容量，p的上限和幽灵链表的容量按它计算
+    void shareWeight(std::atomic<size_t>* total, size_t shareCapacity)
+    {
+        auto lock = stats_.lock(mutex_);
+        budget_.share(total);
+        arcCapacity_ = shareCapacity;
+    }
+
+    // 与其他分片共享目标容量p(分片缓存使用)，需在写入任何数据之前调用
+    // total记录所有分片p的总和，任一分片命中幽灵链表都调整它，各分片按平均值(total / shards)决定驱逐哪一边
+    void shareTarget(std::atomic<size_t>* total, size_t shards)
+    {
+        auto lock = stats_.lock(mutex_);
+        sharedTarget_ = total;
+        targetShards_ = std::max<size_t>(shards, 1);
+    }
+
+private:
+    ArcCache(size_t capacity, Weigher<Key, Value> weigher, size_t transformThreshold, ArcMode mode, int)
         : capacity_(capacity)
-        , transformThreshold_(transformThreshold)
-        , lruPart_(std::make_unique<ArcLruPart<Key, Value>>(capacity, transformThreshold))
-        , lfuPart_(std::make_unique<ArcLfuPart<Key, Value>>(capacity, transformThreshold))
+        , arcCapacity_(capacity)
+        , transformThreshold_(std::max<size_t>(transformThreshold, 1))
+        , mode_(mode)
+        , defaultTtlMs_(0)
+        , budget_(capacity, std::move(weigher), kEntryOverhead)
+        , target_(0)
+        , sharedTarget_(nullptr)
+        , targetShards_(1)
+        , residentCount_(0)
+        , freqHead_(nullptr)
     {}
 
-    ~ArcCache() override = default;
+    template<typename V>
+    void putImpl(const Key& key, V&& value, uint64_t expireAt)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        putLocked(key, std::forward<V>(value), expireAt);
+    }
+
+    uint64_t defaultExpireAt() const
+    {
+        return CoarseClock::expireAt(std::chrono::milliseconds(defaultTtlMs_.load(std::memory_order_relaxed)));
+    }
+
+    static bool expired(const Node* node)
+    {
+        return node->expireAt != 0 && node->expireAt <= CoarseClock::nowMs();
+    }
 
-    void put(Key key, Value value) override 
+    // 需持有mutex_：未命中时检查幽灵链表，命中幽灵链表只调整p，仍按未命中处理(原始ARC模式下留给写入处理)
+    template<typename Visitor>
+    bool visitLocked(const Key& key, Visitor&& visitor)
     {
-        bool inGhost = checkGhostCaches(key);
-        
-        if (!inGhost) 
+        auto it = index_.find(key);
+        if (it == index_.end())
         {
-            if (lruPart_->put(key, value)) 
-            {
-                lfuPart_->put(key, value);
-            }
-        } else 
+            stats_.add(detail::Stat::Miss);
+            if (mode_ == ArcMode::Adaptive)
+                checkGhostCaches(key);
+            return false;
+        }
+
+        Node* node = it->second;
+        if (expired(node))
         {
-            lruPart_->put(key, value);
+            removeResident(node);
+            stats_.add(detail::Stat::Miss);
+            return false;
         }
+        stats_.add(detail::Stat::Hit);
+        touch(node);
+        visitor(static_cast<const Value&>(node->value));
+        return true;
     }
 
-    bool get(Key key, Value& value) override 
+    // 需持有mutex_：存在则更新，否则(命中幽灵链表时先调整p)新建节点进入T1
+    // 原始ARC模式下命中幽灵链表的key直接进入T2
+    template<typename V>
+    void putLocked(const Key& key, V&& value, uint64_t expireAt)
     {
-        checkGhostCaches(key);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            updateResident(it->second, std::forward<V>(value), expireAt);
+            return;
+        }
+        Ghost ghost = checkGhostCaches(key);
 
-        bool shouldTransform = false;
-        if (lruPart_->get(key, value, shouldTransform)) 
+        // 先构造节点才能计算权重，单个条目超出整个预算时不放入
+        Node* node = nodePool_.create(key, std::forward<V>(value));
+        node->charge = budget_.charge(key, node->value);
+        if (!budget_.fits(node->charge))
         {
-            if (shouldTransform) 
-            {
-                lfuPart_->put(key, value);
-            }
-            return true;
+            nodePool_.destroy(node);
+            return;
+        }
+        budget_.add(node->charge);
+        stats_.add(detail::Stat::Insert);
+        while (budget_.overflow() && evictOne(nullptr, ghost == Ghost::B2)) {}
+
+        if (spareIndexNode_)
+        {
+            spareIndexNode_.key() = key;
+            spareIndexNode_.mapped() = node;
+            index_.insert(std::move(spareIndexNode_));
+        }
+        else
+        {
+            index_.emplace(key, node);
+        }
+        if (mode_ == ArcMode::Canonical && ghost != Ghost::None)
+        {
+            node->where = Where::T2;
+            appendList(t2_, node);
         }
-        return lfuPart_->get(key, value);
+        else
+        {
+            linkT1(node);
+        }
+        ++residentCount_;
+        setExpireAt(node, expireAt);
+        if (mode_ == ArcMode::Canonical)
+            trimGhosts();
     }
 
-    Value get(Key key) override 
+    template<typename V>
+    void updateResident(Node* node, V&& value, uint64_t expireAt)
     {
-        Value value{};
-        get(key, value);
-        return value;
+        stats_.add(detail::Stat::Update);
+        node->value = std::forward<V>(value);
+        setExpireAt(node, expireAt);
+        budget_.sub(node->charge);
+        if (node->where == Where::T1) unlinkList(t1_, node);
+        else if (mode_ == ArcMode::Canonical) unlinkList(t2_, node);
+        node->charge = budget_.charge(node->key, node->value);
+        budget_.add(node->charge);
+
+        // 更新在T1中只刷新最近访问位置，在T2中与命中一样提升频率；原始ARC模式下与命中一样移到T2队尾
+        if (mode_ == ArcMode::Canonical)
+        {
+            node->where = Where::T2;
+            appendList(t2_, node);
+        }
+        else if (node->where == Where::T1) appendList(t1_, node);
+        else promote(node);
+        // 更新后的value本身就超出整个预算时直接删除，否则value变大可能超出预算，继续驱逐(不驱逐刚更新的节点)
+        if (!budget_.fits(node->charge))
+        {
+            removeResident(node);
+            return;
+        }
+        while (budget_.overflow() && evictOne(node)) {}
+    }
+
+    // 命中：T1中的节点访问次数达到门槛后移入T2的频率1桶，T2中的节点频率+1
+    // 原始ARC模式下无论在T1还是T2都移到T2的队尾
+    void touch(Node* node)
+    {
+        if (mode_ == ArcMode::Canonical)
+        {
+            unlinkResident(node);
+            node->where = Where::T2;
+            appendList(t2_, node);
+            return;
+        }
+        if (node->where == Where::T2)
+        {
+            promote(node);
+            return;
+        }
+
+        unlinkList(t1_, node);
+        if (++node->accessCount >= transformThreshold_)
+        {
+            FreqBucket* first = freqHead_;
+            if (!first || first->freq != 1)
+                first = insertBucketAfter(nullptr, 1);
+            linkBucket(first, node);
+            node->where = Where::T2;
+            return;
+        }
+        appendList(t1_, node);
+    }
+
+    // 检查幽灵链表，命中时取出该条目并按它的权重调整T1的目标容量p | 返回命中的幽灵链表
+    // 原始ARC模式下步长再乘以另一个幽灵链表与本链表的大小之比(不小于1)
+    Ghost checkGhostCaches(const Key& key)
+    {
+        uint64_t fingerprint = detail::hashKey(key);
+        size_t step = 1;
+        if (b1_.take(fingerprint, &step))
+        {
+            stats_.add(detail::Stat::GhostHit);
+            if (mode_ == ArcMode::Canonical)
+                step *= std::max<size_t>(1, b2_.weight() / (b1_.weight() + step));
+            adjustTarget(step, true);
+            return Ghost::B1;
+        }
+        if (b2_.take(fingerprint, &step))
+        {
+            stats_.add(detail::Stat::GhostHit);
+            if (mode_ == ArcMode::Canonical)
+                step *= std::max<size_t>(1, b1_.weight() / (b2_.weight() + step));
+            adjustTarget(step, false);
+            return Ghost::B2;
+        }
+        return Ghost::None;
+    }
+
+    // 原始ARC的目录大小限制：|T1|+|B1| <= c，|T1|+|T2|+|B1|+|B2| <= 2c，超出时丢弃幽灵链表中最早的条目
+    // T1独占整个容量时，刚被驱逐进B1的条目也会被丢弃，即论文中"直接删除T1的LRU"的情形
+    void trimGhosts()
+    {
+        size_t t1 = t1_.weight;
+        b1_.trim(arcCapacity_ > t1 ? arcCapacity_ - t1 : 0);
+        size_t used = budget_.weight() + b1_.weight();
+        b2_.trim(2 * arcCapacity_ > used ? 2 * arcCapacity_ - used : 0);
+    }
+
+    size_t currentTarget() const
+    {
+        return sharedTarget_ ? sharedTarget_->load(std::memory_order_relaxed) / targetShards_ : target_;
+    }
+
+    // p在[0, arcCapacity_]内增大或减小step；共享时在所有分片的总和上调整，上限相应放大
+    void adjustTarget(size_t step, bool grow)
+    {
+        if (!sharedTarget_)
+        {
+            target_ = grow ? std::min(arcCapacity_, target_ + step) : (target_ > step ? target_ - step : 0);
+            return;
+        }
+        size_t limit = arcCapacity_ * targetShards_;
+        size_t old = sharedTarget_->load(std::memory_order_relaxed);
+        size_t next;
+        do
+        {
+            next = grow ? std::min(limit, old + step) : (old > step ? old - step : 0);
+        } while (!sharedTarget_->compare_exchange_weak(old, next, std::memory_order_relaxed));
+    }
+
+    // 驱逐一个条目到对应的幽灵链表，keep不会被驱逐 | 没有可驱逐的节点时返回false
+    // T1超出目标容量p(或T2没有可驱逐的节点)时驱逐T1最久未访问的节点，否则驱逐T2最小频率桶的队首
+    // 原始ARC模式下T2按LRU驱逐队首；正在插入的key命中B2时，T1恰好等于p也驱逐T1(hitB2)
+    bool evictOne(const Node* keep, bool hitB2 = false)
+    {
+        Node* fromT1 = (keep && t1_.head == keep) ? keep->next : t1_.head;
+        Node* fromT2;
+        if (mode_ == ArcMode::Canonical)
+        {
+            fromT2 = (keep && t2_.head == keep) ? keep->next : t2_.head;
+        }
+        else
+        {
+            fromT2 = freqHead_ ? freqHead_->head : nullptr;
+            if (fromT2 && fromT2 == keep)
+                fromT2 = keep->next ? keep->next : (freqHead_->next ? freqHead_->next->head : nullptr);
+        }
+
+        size_t target = currentTarget();
+        Node* victim;
+        if (fromT1 && (t1_.weight > target || (hitB2 && t1_.weight == target) || !fromT2))
+            victim = fromT1;
+        else if (fromT2)
+            victim = fromT2;
+        else
+            return false;
+
+        // 幽灵链表只记录指纹和权重，节点连同value立即释放
+        detail::GhostList& ghost = victim->where == Where::T1 ? b1_ : b2_;
+        ghost.push(detail::hashKey(victim->key), victim->charge, arcCapacity_);
+        removeResident(victim);
+        stats_.add(detail::Stat::Eviction);
+        return true;
+    }
+
+    // 把节点移出缓存并回收(过期等非策略原因的删除直接调用它，不进入幽灵链表)
+    void removeResident(Node* node)
+    {
+        unlinkResident(node);
+        budget_.sub(node->charge);
+        --residentCount_;
+        // 索引节点留作备用，紧接着的插入(驱逐总是为插入腾位置)直接复用，不必重新分配
+        spareIndexNode_ = index_.extract(node->key);
+        if (wheel_)
+            wheel_->cancel(node);
+        nodePool_.destroy(node);
+    }
+
+    void unlinkResident(Node* node)
+    {
+        if (node->where == Where::T1)
+        {
+            unlinkList(t1_, node);
+        }
+        else if (mode_ == ArcMode::Canonical)
+        {
+            unlinkList(t2_, node);
+        }
+        else
+        {
+            unlinkBucket(node);
+        }
+    }
+
+    void linkT1(Node* node)
+    {
+        node->where = Where::T1;
+        appendList(t1_, node);
+    }
+
+    // 记录过期时刻，需要过期的挂到(或挪到)时间轮上，不再过期的摘下
+    void setExpireAt(Node* node, uint64_t expireAt)
+    {
+        node->expireAt = expireAt;
+        if (expireAt == 0)
+        {
+            if (wheel_)
+                wheel_->cancel(node);
+            return;
+        }
+        if (!wheel_)
+            wheel_ = std::make_unique<TimerWheel<Node>>(CoarseClock::nowMs());
+        wheel_->schedule(node);
+    }
+
+    // 推进时间轮，回收已到期的节点
+    void expireLocked()
+    {
+        if (!wheel_ || wheel_->empty())
+            return;
+
+        wheel_->advance(CoarseClock::nowMs(), [this](Node* node) {
+            removeResident(node);
+        });
+    }
+
+    static void appendList(NodeList& list, Node* node)
+    {
+        node->pre = list.tail;
+        node->next = nullptr;
+        if (list.tail)
+            list.tail->next = node;
+        else
+            list.head = node;
+        list.tail = node;
+        list.weight += node->charge;
+    }
+
+    static void unlinkList(NodeList& list, Node* node)
+    {
+        if (node->pre)
+            node->pre->next = node->next;
+        else
+            list.head = node->next;
+        if (node->next)
+            node->next->pre = node->pre;
+        else
+            list.tail = node->pre;
+        node->pre = node->next = nullptr;
+        list.weight -= node->charge;
+    }
+
+    // T2中的节点挪到(频率+1)的桶，没有则紧挨着当前桶新建一个
+    void promote(Node* node)
+    {
+        FreqBucket* bucket = node->bucket;
+        FreqBucket* next = bucket->next;
+        size_t freq = bucket->freq + 1;
+
+        if (bucket->head == bucket->tail && (!next || next->freq != freq))
+        {
+            // 桶里只有这一个节点，直接改桶的频率即可
+            bucket->freq = freq;
+            return;
+        }
+        if (!next || next->freq != freq)
+            next = insertBucketAfter(bucket, freq);
+        unlinkBucket(node);
+        linkBucket(next, node);
+    }
+
+    // 把节点加到频率桶的队尾
+    void linkBucket(FreqBucket* bucket, Node* node)
+    {
+        node->bucket = bucket;
+        node->pre = bucket->tail;
+        node->next = nullptr;
+        if (bucket->tail)
+            bucket->tail->next = node;
+        else
+            bucket->head = node;
+        bucket->tail = node;
+    }
+
+    // 把节点移出所在的频率桶，桶空了则回收
+    void unlinkBucket(Node* node)
+    {
+        FreqBucket* bucket = node->bucket;
+        if (node->pre)
+            node->pre->next = node->next;
+        else
+            bucket->head = node->next;
+        if (node->next)
+            node->next->pre = node->pre;
+        else
+            bucket->tail = node->pre;
+        node->pre = node->next = nullptr;
+        node->bucket = nullptr;
+
+        if (!bucket->head)
+            removeBucket(bucket);
+    }
+
+    // pre为空时插到最前面
+    FreqBucket* insertBucketAfter(FreqBucket* pre, size_t freq)
+    {
+        FreqBucket* bucket = bucketPool_.create(freq);
+        bucket->pre = pre;
+        bucket->next = pre ? pre->next : freqHead_;
+        if (bucket->next)
+            bucket->next->pre = bucket;
+        if (pre)
+            pre->next = bucket;
+        else
+            freqHead_ = bucket;
+        return bucket;
+    }
+
+    void removeBucket(FreqBucket* bucket)
+    {
+        if (bucket->pre)
+            bucket->pre->next = bucket->next;
+        else
+            freqHead_ = bucket->next;
+        if (bucket->next)
+            bucket->next->pre = bucket->pre;
+        bucketPool_.destroy(bucket);
     }
 
 private:
-    bool checkGhostCaches(Key key) 
+    size_t capacity_;
+    size_t arcCapacity_; // p的上限与幽灵链表的容量，单独使用时等于capacity_，共享总权重的分片为它名义上分到的份额
+    size_t transformThreshold_; // T1中的访问次数达到它时移入T2
+    ArcMode mode_;
+    std::atomic<int64_t> defaultTtlMs_; // 默认TTL(毫秒)，0表示永不过期
+    std::mutex mutex_;
+
+    detail::WeightBudget<Key, Value> budget_; // T1与T2的容量记账，默认按条目数
+    size_t target_; // T1的目标容量p，T2的目标为(容量 - p)
+    std::atomic<size_t>* sharedTarget_; // 分片共享的p的总和，为空时使用target_
+    size_t targetShards_; // 共享p的分片数
+    size_t residentCount_; // T1与T2中的条目数
+    NodeMap index_; // key -> T1/T2中的节点
+    typename NodeMap::node_type spareIndexNode_; // 最近一次删除留下的索引节点
+    NodeList t1_;
+    NodeList t2_; // 原始ARC模式下的T2，默认模式下T2由频率桶组成
+    detail::GhostList b1_; // T1被驱逐条目的指纹
+    detail::GhostList b2_; // T2被驱逐条目的指纹
+    FreqBucket* freqHead_; // T2中频率最小的桶，驱逐从这里开始
+
+    detail::ObjectPool<Node> nodePool_; // 节点对象池
+    detail::ObjectPool<FreqBucket> bucketPool_; // 频率桶对象池，空桶回收后复用
+    std::unique_ptr<TimerWheel<Node>> wheel_; // 过期时间轮，第一次写入带TTL的条目时才创建
+    detail::StatsCounter stats_; // 运行统计
+};
+
+// 分片ARC的自适应方式
+enum class ArcAdaptation
+{
+    PerShard, // 每个分片按自己的幽灵链表命中独立调整p
+    Shared    // 所有分片共享同一个p，任一分片的幽灵命中都会影响全部分片
+};
+
+// 分片ARC：按key的混合哈希分到多个独立加锁的ArcCache，结构与HashLruCaches/KHashLfuCache相同
+// 默认每个分片独立调整T1/T2的划分；key分布均匀、各分片负载相似时可以共享p，
+// 让一次幽灵命中的信息对所有分片生效，分片多、单个分片样本少时适应得更快
+template<typename Key, typename Value>
+class HashArcCache
+{
+public:
+    using Slice = CacheLineAligned<ArcCache<Key, Value>>;
+
+    // sliceNum会向上取整到2的幂，以便用掩码选择分片
+    HashArcCache(size_t capacity, int sliceNum, size_t transformThreshold = 2,
+                 ArcAdaptation adaptation = ArcAdaptation::PerShard, ArcMode mode = ArcMode::Adaptive)
+        : capacity_(capacity)
+        , sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()))
+        , sliceMask_(sliceNum_ - 1)
+        , totalWeight_(0)
+        , sharedTarget_(0)
     {
-        bool inGhost = false;
-        if (lruPart_->checkGhost(key)) 
+        size_t sliceSize = std::ceil(capacity_ / static_cast<double>(sliceNum_)); // 每个arc分片的容量
+        for (size_t i = 0; i < sliceNum_; ++i)
         {
-            if (lfuPart_->decreaseCapacity()) 
-            {
-                lruPart_->increaseCapacity();
-            }
-            inGhost = true;
-        } 
-        else if (lfuPart_->checkGhost(key)) 
+            arcSliceCaches_.emplace_back(new Slice(sliceSize, transformThreshold, mode));
+            if (adaptation == ArcAdaptation::Shared)
+                arcSliceCaches_.back()->value.shareTarget(&sharedTarget_.value, sliceNum_);
+        }
+    }
+
+    // 按字节限制容量：maxWeight是所有分片共享的全局字节预算，做法同HashLruCaches
+    // p和幽灵链表按每个分片平均分到的预算(maxWeight / 分片数)计算
+    HashArcCache(size_t maxWeight, int sliceNum, Weigher<Key, Value> weigher, size_t transformThreshold = 2,
+                 ArcAdaptation adaptation = ArcAdaptation::PerShard, ArcMode mode = ArcMode::Adaptive)
+        : capacity_(maxWeight)
+        , sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()))
+        , sliceMask_(sliceNum_ - 1)
+        , totalWeight_(0)
+        , sharedTarget_(0)
+    {
+        size_t share = std::max<size_t>(maxWeight / sliceNum_, 1);
+        for (size_t i = 0; i < sliceNum_; ++i)
+        {
+            arcSliceCaches_.emplace_back(new Slice(maxWeight, weigher, transformThreshold, mode));
+            arcSliceCaches_.back()->value.shareWeight(&totalWeight_.value, share);
+            if (adaptation == ArcAdaptation::Shared)
+                arcSliceCaches_.back()->value.shareTarget(&sharedTarget_.value, sliceNum_);
+        }
+    }
+
+    void put(const Key& key, const Value& value)
+    {
+        observe(key, false);
+        slice(key).put(key, value);
+    }
+
+    void put(const Key& key, Value&& value)
+    {
+        observe(key, false);
+        slice(key).put(key, std::move(value));
+    }
+
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
+    {
+        observe(key, false);
+        slice(key).putWithTtl(key, std::forward<V>(value), ttl);
+    }
+
+    void setDefaultTtl(std::chrono::milliseconds ttl)
+    {
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            arcSliceCache->value.setDefaultTtl(ttl);
+        }
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        observe(key, true);
+        return slice(key).get(key, value);
+    }
+
+    Value get(const Key& key)
+    {
+        observe(key, true);
+        return slice(key).get(key);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        observe(key, true);
+        return slice(key).visit(key, std::forward<Visitor>(visitor));
+    }
+
+    // 读取key，未命中时加载并写入所在分片，并发未命中按分片合并，做法同HashLruCaches::getOrLoad
+    template<typename Loader>
+    Value getOrLoad(const Key& key, Loader&& loader)
+    {
+        observe(key, true);
+        return slice(key).getOrLoad(key, std::forward<Loader>(loader));
+    }
+
+    // 批量读取：先按分片分组，每个分片只加一次锁 | 返回命中个数
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found)
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        observeAll(keys, keys.size(), true);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(keys.size(), sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        size_t hits = 0;
+        for (size_t s = 0; s < sliceNum_; ++s)
+        {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0)
+                continue;
+            hits += arcSliceCaches_[s]->value.visitBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j, const Value& v) { values[group[j]] = v; found[group[j]] = true; });
+        }
+        return hits;
+    }
+
+    // 批量写入：先按分片分组，每个分片只加一次锁
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values)
+    {
+        size_t total = std::min(keys.size(), values.size());
+        observeAll(keys, total, false);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(total, sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        for (size_t s = 0; s < sliceNum_; ++s)
+        {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0)
+                continue;
+            arcSliceCaches_[s]->value.putBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j) -> const Value& { return values[group[j]]; });
+        }
+    }
+
+    size_t sliceNum() const { return sliceNum_; }
+
+    // 所有分片的总权重：未设weigher时等于条目数
+    size_t weight()
+    {
+        size_t total = 0;
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            total += arcSliceCache->value.weight();
+        }
+        return total;
+    }
+
+    // key所在的分片下标
+    size_t sliceIndex(const Key& key) const
+    {
+        return detail::sliceIndex(detail::hashKey(key), sliceMask_);
+    }
+
+    // 各分片当前的条目数
+    std::vector<size_t> sliceSizes()
+    {
+        std::vector<size_t> sizes;
+        for (auto& arcSliceCache : arcSliceCaches_)
         {
-            if (lruPart_->decreaseCapacity()) 
+            sizes.push_back(arcSliceCache->value.size());
+        }
+        return sizes;
+    }
+
+    // 各分片当前的目标容量p，用于观察各分片的T1/T2划分
+    std::vector<size_t> sliceTargets()
+    {
+        std::vector<size_t> targets;
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            targets.push_back(arcSliceCache->value.target());
+        }
+        return targets;
+    }
+
+    // 所有分片的ARC状态之和(target为各分片p之和，与总容量对应)
+    ArcStats arcStats()
+    {
+        ArcStats total;
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            total += arcSliceCache->value.arcStats();
+        }
+        return total;
+    }
+
+    // 所有分片进行中的getOrLoad加载数
+    size_t loadsInFlight() const
+    {
+        size_t total = 0;
+        for (const auto& arcSliceCache : arcSliceCaches_)
+        {
+            total += arcSliceCache->value.loadsInFlight();
+        }
+        return total;
+    }
+
+    // 所有分片的运行统计之和
+    CacheStats stats()
+    {
+        CacheStats total;
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            total += arcSliceCache->value.stats();
+        }
+        return total;
+    }
+
+    // 各分片的运行统计
+    std::vector<CacheStats> sliceStats()
+    {
+        std::vector<CacheStats> stats;
+        for (auto& arcSliceCache : arcSliceCaches_)
+        {
+            stats.push_back(arcSliceCache->value.stats());
+        }
+        return stats;
+    }
+
+    // 挂接未命中率曲线估计器，做法同HashLruCaches::attachMrc
+    void attachMrc(MrcEstimator* mrc)
+    {
+        mrc_.store(mrc, std::memory_order_release);
+    }
+
+    MrcEstimator* mrc() const { return mrc_.load(std::memory_order_acquire); }
+
+private:
+    ArcCache<Key, Value>& slice(const Key& key)
+    {
+        return arcSliceCaches_[sliceIndex(key)]->value;
+    }
+
+    void observe(const Key& key, bool counted)
+    {
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire))
+            mrc->record(key, counted);
+    }
+
+    void observeAll(const std::vector<Key>& keys, size_t count, bool counted)
+    {
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire))
+        {
+            for (size_t i = 0; i < count; ++i)
             {
-                lfuPart_->increaseCapacity();
+                mrc->record(keys[i], counted);
             }
-            inGhost = true;
         }
-        return inGhost;
     }
 
 private:
-    size_t capacity_;
-    size_t transformThreshold_;
-    std::unique_ptr<ArcLruPart<Key, Value>> lruPart_;
-    std::unique_ptr<ArcLfuPart<Key, Value>> lfuPart_;
+    size_t capacity_; // 缓存总容量
+    size_t sliceNum_; // 缓存分片数量(2的幂)
+    size_t sliceMask_;
+    CacheLineAligned<std::atomic<size_t>> totalWeight_;  // 按字节限制时各分片共享的全局总权重
+    CacheLineAligned<std::atomic<size_t>> sharedTarget_; // 共享自适应时所有分片p的总和
+    std::vector<std::unique_ptr<Slice>> arcSliceCaches_; // 分片按缓存行对齐，避免相邻分片的锁伪共享
+    std::atomic<MrcEstimator*> mrc_{nullptr}; // 挂接的未命中率曲线估计器，可为空
 };
 
-} // namespace Cache
\ No newline at end of file
+} // namespace Cache
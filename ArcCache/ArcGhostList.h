@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Cache
+{
+
+namespace detail
+{
+
+// ARC的幽灵链表：只记录被驱逐条目的key指纹(64位混合哈希)和权重，不保留key、value和缓存节点
+// 条目按进入的先后存放在环形数组里，超出容量时丢弃最早的条目(FIFO老化)；
+// 另有一张开放寻址(线性探测)的索引表，按指纹找到环形数组中的位置，命中时O(1)取出；
+// 索引槽里同时存放指纹的高32位，探测时先比较它，不必逐个回到环形数组里取指纹
+// 命中取出的条目只在环形数组中标记为已删除，等轮到它出队时跳过；环形数组满时压缩或扩容
+// 每个条目约占 16字节(环形数组) + 16字节(索引表，负载不超过1/2)；指纹冲突的概率可以忽略
+class GhostList
+{
+public:
+    GhostList()
+        : head_(0)
+        , tail_(0)
+        , count_(0)
+        , weight_(0)
+    {
+        rebuild(kMinRing);
+    }
+
+    // 记录一个被驱逐的条目，总权重超出capacity时先丢弃最早的条目
+    void push(uint64_t fingerprint, size_t charge, size_t capacity)
+    {
+        while (weight_ + charge > capacity && count_ > 0)
+        {
+            popOldest();
+        }
+        if (tail_ - head_ == ring_.size())
+        {
+            // 一半以上是已删除的空位时原样压缩，否则扩容一倍
+            rebuild(count_ * 2 <= ring_.size() ? ring_.size() : ring_.size() * 2);
+        }
+
+        size_t pos = tail_ & (ring_.size() - 1);
+        ring_[pos] = Entry{fingerprint, charge};
+        insertIndex(fingerprint, static_cast<uint32_t>(pos));
+        ++tail_;
+        ++count_;
+        weight_ += charge;
+    }
+
+    // 命中时取出该条目，charge传出它的权重 | 不存在时返回false
+    bool take(uint64_t fingerprint, size_t* charge = nullptr)
+    {
+        size_t slot = findSlot(fingerprint);
+        if (slot == kNotFound)
+            return false;
+
+        Entry& entry = ring_[table_[slot].pos];
+        if (charge) *charge = entry.charge;
+        weight_ -= entry.charge;
+        entry.charge = kDead;
+        eraseSlot(slot);
+        --count_;
+        return true;
+    }
+
+    // 丢弃最早的条目，直到总权重不超过capacity
+    void trim(size_t capacity)
+    {
+        while (weight_ > capacity && count_ > 0)
+        {
+            popOldest();
+        }
+    }
+
+    bool contains(uint64_t fingerprint) const
+    {
+        return findSlot(fingerprint) != kNotFound;
+    }
+
+    size_t size() const { return count_; }
+    size_t weight() const { return weight_; }
+
+    // 环形数组与索引表占用的字节数
+    size_t memoryBytes() const
+    {
+        return ring_.capacity() * sizeof(Entry) + table_.capacity() * sizeof(Slot);
+    }
+
+private:
+    static constexpr size_t   kMinRing = 16;
+    static constexpr size_t   kNotFound = SIZE_MAX;
+    static constexpr uint32_t kEmpty = UINT32_MAX;
+    static constexpr size_t   kDead = SIZE_MAX; // 已被取出的条目
+
+    struct Entry
+    {
+        uint64_t fingerprint;
+        size_t   charge;
+    };
+
+    struct Slot
+    {
+        uint32_t pos; // 环形数组下标，kEmpty为空槽
+        uint32_t tag; // 指纹的高32位
+    };
+
+    static uint32_t tagOf(uint64_t fingerprint)
+    {
+        return static_cast<uint32_t>(fingerprint >> 32);
+    }
+
+    size_t findSlot(uint64_t fingerprint) const
+    {
+        size_t mask = table_.size() - 1;
+        uint32_t tag = tagOf(fingerprint);
+        for (size_t i = fingerprint & mask; table_[i].pos != kEmpty; i = (i + 1) & mask)
+        {
+            if (table_[i].tag == tag && ring_[table_[i].pos].fingerprint == fingerprint)
+                return i;
+        }
+        return kNotFound;
+    }
+
+    void insertIndex(uint64_t fingerprint, uint32_t pos)
+    {
+        size_t mask = table_.size() - 1;
+        size_t i = fingerprint & mask;
+        while (table_[i].pos != kEmpty)
+        {
+            i = (i + 1) & mask;
+        }
+        table_[i] = Slot{pos, tagOf(fingerprint)};
+    }
+
+    // 线性探测的删除：把后面探测链上的条目往回挪，不留墓碑
+    void eraseSlot(size_t slot)
+    {
+        size_t mask = table_.size() - 1;
+        size_t hole = slot;
+        for (size_t i = (slot + 1) & mask; table_[i].pos != kEmpty; i = (i + 1) & mask)
+        {
+            size_t home = ring_[table_[i].pos].fingerprint & mask;
+            // home不在(hole, i]区间内时，这个条目可以挪到空位上
+            bool between = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+            if (!between)
+            {
+                table_[hole] = table_[i];
+                hole = i;
+            }
+        }
+        table_[hole].pos = kEmpty;
+    }
+
+    // 丢弃最早的未删除条目
+    void popOldest()
+    {
+        while (head_ < tail_)
+        {
+            size_t pos = head_ & (ring_.size() - 1);
+            ++head_;
+            Entry& entry = ring_[pos];
+            if (entry.charge == kDead)
+                continue;
+
+            size_t mask = table_.size() - 1;
+            size_t slot = entry.fingerprint & mask;
+            while (table_[slot].pos != pos)
+            {
+                slot = (slot + 1) & mask;
+            }
+            eraseSlot(slot);
+            weight_ -= entry.charge;
+            entry.charge = kDead;
+            --count_;
+            return;
+        }
+    }
+
+    // 按原有顺序把未删除的条目搬到容量为ringSize的新环形数组，并重建索引表
+    void rebuild(size_t ringSize)
+    {
+        std::vector<Entry> ring(ringSize);
+        size_t n = 0;
+        for (uint64_t seq = head_; seq < tail_; ++seq)
+        {
+            const Entry& entry = ring_[seq & (ring_.size() - 1)];
+            if (entry.charge != kDead)
+                ring[n++] = entry;
+        }
+        ring_.swap(ring);
+        head_ = 0;
+        tail_ = n;
+        table_.assign(ringSize * 2, Slot{kEmpty, 0});
+        for (size_t i = 0; i < n; ++i)
+        {
+            insertIndex(ring_[i].fingerprint, static_cast<uint32_t>(i));
+        }
+    }
+
+private:
+    std::vector<Entry>    ring_;   // 环形数组，容量为2的幂
+    std::vector<Slot>     table_;  // 指纹 -> 环形数组下标
+    uint64_t              head_;   // 最早条目的序号(对环形数组容量取模即下标)
+    uint64_t              tail_;   // 下一个条目的序号
+    size_t                count_;  // 未删除的条目数
+    size_t                weight_; // 未删除条目的总权重
+};
+
+} // namespace detail
+
+} // namespace Cache
@@ -1,5 +1,13 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "CacheStats.h"
+#include "SingleFlight.h"
+
 namespace Cache
 {
 
@@ -7,16 +15,101 @@ template <typename Key, typename Value>
 class CachePolicy
 {
 public:
-    virtual ~CachePolicy() {};
+    virtual ~CachePolicy()
+    {
+        delete flights_.load(std::memory_order_acquire);
+    }
 
     // 添加缓存接口
-    virtual void put(Key key, Value value) = 0;
+    virtual void put(const Key& key, const Value& value) = 0;
+    // 右值版本：value直接移动进缓存，避免一次拷贝
+    virtual void put(const Key& key, Value&& value) = 0;
 
     // key是传入参数  访问到的值以传出参数的形式返回 | 访问成功返回true
-    virtual bool get(Key key, Value& value) = 0;
+    virtual bool get(const Key& key, Value& value) = 0;
     // 如果缓存中能找到key，则直接返回value
-    virtual Value get(Key key) = 0;
+    virtual Value get(const Key& key) = 0;
+
+    // 命中时在缓存锁内以只读引用调用visitor，不拷贝value | 命中返回true
+    // 默认实现退化为拷贝，具体策略应当重写
+    virtual bool visit(const Key& key, const std::function<void(const Value&)>& visitor)
+    {
+        Value value{};
+        if (!get(key, value)) return false;
+        visitor(value);
+        return true;
+    }
+
+    // 批量读取：values[i]、found[i]对应keys[i] | 返回命中个数
+    // 默认实现逐个调用get，具体策略应当重写为整批只加一次锁
+    virtual size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found)
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        size_t hits = 0;
+        for (size_t i = 0; i < keys.size(); ++i)
+        {
+            found[i] = get(keys[i], values[i]);
+            hits += found[i];
+        }
+        return hits;
+    }
+
+    // 批量写入：keys[i]对应values[i]
+    virtual void putMany(const std::vector<Key>& keys, const std::vector<Value>& values)
+    {
+        for (size_t i = 0; i < keys.size() && i < values.size(); ++i)
+        {
+            put(keys[i], values[i]);
+        }
+    }
+
+    // 运行统计的快照(命中、未命中、写入、驱逐、锁等待等)，默认实现不做统计
+    virtual CacheStats stats()
+    {
+        return CacheStats{};
+    }
+
+    // 读取key，未命中时调用loader(key)加载并写入缓存 | 返回缓存中或加载得到的value
+    // 同一个key的并发未命中只调用一次loader，其余调用者等待并共享结果；loader在缓存锁外执行，
+    // 抛出的异常交给所有等待者，不写入缓存。写入缓存先于结果公布，之后再未命中的调用者会直接读到它
+    // 进行中加载的登记表在第一次调用时才创建，不用getOrLoad的缓存只多一个空指针
+    template<typename Loader>
+    Value getOrLoad(const Key& key, Loader&& loader)
+    {
+        Value value{};
+        if (get(key, value)) return value;
+        return flights().run(key, [&]() -> Value {
+            // 从未命中到登记加载之间，上一次加载可能刚好完成
+            Value loaded{};
+            if (get(key, loaded)) return loaded;
+            loaded = loader(key);
+            put(key, loaded);
+            return loaded;
+        });
+    }
+
+    // 进行中的getOrLoad加载数
+    size_t loadsInFlight() const
+    {
+        SingleFlight<Key, Value>* flights = flights_.load(std::memory_order_acquire);
+        return flights ? flights->inFlight() : 0;
+    }
+
+private:
+    // 取登记表，没有就创建；并发创建时只有一个胜出，其余的删掉自己的
+    SingleFlight<Key, Value>& flights()
+    {
+        SingleFlight<Key, Value>* flights = flights_.load(std::memory_order_acquire);
+        if (flights) return *flights;
+        SingleFlight<Key, Value>* created = new SingleFlight<Key, Value>();
+        if (flights_.compare_exchange_strong(flights, created, std::memory_order_acq_rel)) return *created;
+        delete created;
+        return *flights;
+    }
 
+private:
+    std::atomic<SingleFlight<Key, Value>*> flights_{nullptr}; // getOrLoad进行中加载的登记表，第一次用到时创建
 };
 
-} // namespace Cache
\ No newline at end of file
+} // namespace Cache
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// 缓存运行统计的快照，各分片的快照可以直接相加
+// 未命中不区分原因(不存在或已过期)；驱逐只统计因容量不足淘汰的条目，不含过期回收和remove
+struct CacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t inserts = 0;      // 新写入的条目
+    uint64_t updates = 0;      // 覆盖已存在条目的写入
+    uint64_t evictions = 0;    // 因容量不足淘汰的条目
+    uint64_t ghostHits = 0;    // 不在缓存中、但在策略保留的历史记录中找到并据此调整(ARC的B1/B2、LRU-K的历史队列、CLOCK-Pro的测试页)
+    uint64_t agingPasses = 0;  // 频次老化(LFU的平均频次减半、W-TinyLFU的计数器减半)的次数
+    uint64_t lockWaits = 0;    // 没能立即拿到锁、需要等待的次数
+    uint64_t lockWaitNs = 0;   // 等待锁的总时间(纳秒)
+
+    CacheStats& operator+=(const CacheStats& other)
+    {
+        hits += other.hits;
+        misses += other.misses;
+        inserts += other.inserts;
+        updates += other.updates;
+        evictions += other.evictions;
+        ghostHits += other.ghostHits;
+        agingPasses += other.agingPasses;
+        lockWaits += other.lockWaits;
+        lockWaitNs += other.lockWaitNs;
+        return *this;
+    }
+
+    double hitRate() const
+    {
+        uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / total : 0.0;
+    }
+};
+
+namespace detail
+{
+
+enum class Stat : uint8_t
+{
+    Hit,
+    Miss,
+    Insert,
+    Update,
+    Eviction,
+    GhostHit,
+    AgingPass,
+    LockWait,
+    LockWaitNs,
+    Count
+};
+
+// 统计计数器，分两种写法，快照时全部相加：
+// add:           调用方持有缓存的独占锁，写到锁保护的一组计数上，只是普通的读-加-写(relaxed原子读写，
+//                无锁前缀指令)，与锁本身在同一批缓存行上往来，热路径上几乎没有额外开销
+// addConcurrent: 没有独占锁的路径(共享锁下的读、读缓冲模式的命中)，按threadStripe()落到按线程分条的
+//                计数上做relaxed原子加，不同线程基本不会写同一缓存行
+// 计数器只保证最终准确，快照与正在进行的操作之间没有一致性要求
+class StatsCounter
+{
+public:
+    StatsCounter() = default;
+    StatsCounter(const StatsCounter&) = delete;
+    StatsCounter& operator=(const StatsCounter&) = delete;
+
+    // 需持有独占锁
+    void add(Stat stat, uint64_t n = 1)
+    {
+        std::atomic<uint64_t>& count = locked_.counts[static_cast<size_t>(stat)];
+        count.store(count.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void addConcurrent(Stat stat, uint64_t n = 1)
+    {
+        stripes_[threadStripe() & (kStripes - 1)].counts[static_cast<size_t>(stat)]
+            .fetch_add(n, std::memory_order_relaxed);
+    }
+
+    CacheStats snapshot() const
+    {
+        std::array<uint64_t, kStatCount> sum{};
+        for (size_t i = 0; i < kStatCount; ++i)
+        {
+            sum[i] = locked_.counts[i].load(std::memory_order_relaxed);
+        }
+        for (const Stripe& stripe : stripes_)
+        {
+            for (size_t i = 0; i < kStatCount; ++i)
+            {
+                sum[i] += stripe.counts[i].load(std::memory_order_relaxed);
+            }
+        }
+        CacheStats stats;
+        stats.hits = sum[static_cast<size_t>(Stat::Hit)];
+        stats.misses = sum[static_cast<size_t>(Stat::Miss)];
+        stats.inserts = sum[static_cast<size_t>(Stat::Insert)];
+        stats.updates = sum[static_cast<size_t>(Stat::Update)];
+        stats.evictions = sum[static_cast<size_t>(Stat::Eviction)];
+        stats.ghostHits = sum[static_cast<size_t>(Stat::GhostHit)];
+        stats.agingPasses = sum[static_cast<size_t>(Stat::AgingPass)];
+        stats.lockWaits = sum[static_cast<size_t>(Stat::LockWait)];
+        stats.lockWaitNs = sum[static_cast<size_t>(Stat::LockWaitNs)];
+        return stats;
+    }
+
+    // 需持有独占锁
+    void reset()
+    {
+        for (auto& count : locked_.counts)
+        {
+            count.store(0, std::memory_order_relaxed);
+        }
+        for (Stripe& stripe : stripes_)
+        {
+            for (auto& count : stripe.counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 加独占锁并统计等待：先try_lock，拿不到时才计时并阻塞等待，不争抢时没有额外开销
+    template<typename Mutex>
+    std::unique_lock<Mutex> lock(Mutex& mutex)
+    {
+        if (!mutex.try_lock())
+        {
+            auto start = std::chrono::steady_clock::now();
+            mutex.lock();
+            uint64_t waited = elapsedNs(start);
+            add(Stat::LockWait);
+            add(Stat::LockWaitNs, waited);
+        }
+        return std::unique_lock<Mutex>(mutex, std::adopt_lock);
+    }
+
+    // 加共享锁并统计等待
+    template<typename Mutex>
+    std::shared_lock<Mutex> lockShared(Mutex& mutex)
+    {
+        if (!mutex.try_lock_shared())
+        {
+            auto start = std::chrono::steady_clock::now();
+            mutex.lock_shared();
+            uint64_t waited = elapsedNs(start);
+            addConcurrent(Stat::LockWait);
+            addConcurrent(Stat::LockWaitNs, waited);
+        }
+        return std::shared_lock<Mutex>(mutex, std::adopt_lock);
+    }
+
+private:
+    static constexpr size_t kStripes = 8;
+    static constexpr size_t kStatCount = static_cast<size_t>(Stat::Count);
+
+    struct alignas(kCacheLineSize) Stripe
+    {
+        std::array<std::atomic<uint64_t>, kStatCount> counts{};
+    };
+
+    static uint64_t elapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    Stripe                       locked_;  // 持有独占锁时写入
+    std::array<Stripe, kStripes> stripes_; // 没有独占锁时按线程分条写入
+};
+
+} // namespace detail
+
+} // namespace Cache
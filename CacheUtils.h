@@ -0,0 +1,311 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cache
+{
+
+// 缓存行大小，用于分片等热点结构的对齐
+constexpr size_t kCacheLineSize = 64;
+
+// 按缓存行对齐并填充的包装，保证相邻对象(如各分片的锁)不会落在同一缓存行上
+template<typename T>
+struct alignas(kCacheLineSize) CacheLineAligned
+{
+    template<typename... Args>
+    explicit CacheLineAligned(Args&&... args)
+        : value(std::forward<Args>(args)...) {}
+
+    T value;
+};
+
+// 权重函数：返回一个条目的大小(通常是value占用的字节数)，用于按字节限制缓存容量
+template<typename Key, typename Value>
+using Weigher = std::function<size_t(const Key&, const Value&)>;
+
+namespace detail
+{
+
+// 64位混合函数(splitmix64的finalizer)，std::hash对整数是恒等映射，需要再打散一次
+inline uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+template<typename Key>
+inline uint64_t hashKey(const Key& key)
+{
+    return mixHash(static_cast<uint64_t>(std::hash<Key>{}(key)));
+}
+
+// 把哈希值映射到[0, n)，用乘法代替取模(Lemire fastrange)，n不要求是2的幂
+inline uint32_t fastRange(uint64_t h, uint32_t n)
+{
+    return static_cast<uint32_t>(((h >> 32) * static_cast<uint64_t>(n)) >> 32);
+}
+
+// 不小于n的最小2的幂(n为0时返回1)
+inline size_t nextPowerOfTwo(size_t n)
+{
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// 分片下标：取混合后哈希的高32位再按掩码选择，
+// 低位留给分片内部(如LRUCache的索引分段)使用，避免分片内所有key落在同一段
+inline size_t sliceIndex(uint64_t h, size_t mask)
+{
+    return static_cast<size_t>(h >> 32) & mask;
+}
+
+// 软件预取：批量操作中提前发起后续元素的访存，让多次cache miss重叠(memory-level parallelism)
+inline void prefetch(const void* addr)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(addr);
+#else
+    (void)addr;
+#endif
+}
+
+// 64位整数中1的个数
+inline uint32_t popCount(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcountll(bits));
+#else
+    bits = bits - ((bits >> 1) & 0x5555555555555555ULL);
+    bits = (bits & 0x3333333333333333ULL) + ((bits >> 2) & 0x3333333333333333ULL);
+    bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<uint32_t>((bits * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// 最低位的1所在的位置，bits不能为0
+inline uint32_t lowestBit(uint64_t bits)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_ctzll(bits));
+#else
+    uint32_t n = 0;
+    while (!(bits & 1)) { bits >>= 1; ++n; }
+    return n;
+#endif
+}
+
+// 按分片对批量请求分组(计数排序)：order中属于分片s的下标位于[offsets[s], offsets[s + 1])，
+// 组内保持原有相对顺序，这样每个分片只需加一次锁
+template<typename SliceOf>
+inline void groupBySlice(size_t count, size_t sliceNum, SliceOf&& sliceOf,
+                         std::vector<uint32_t>& order, std::vector<uint32_t>& offsets)
+{
+    std::vector<uint32_t> slices(count);
+    offsets.assign(sliceNum + 1, 0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        slices[i] = static_cast<uint32_t>(sliceOf(i));
+        ++offsets[slices[i] + 1];
+    }
+    for (size_t s = 0; s < sliceNum; ++s)
+    {
+        offsets[s + 1] += offsets[s];
+    }
+    order.resize(count);
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < count; ++i)
+    {
+        order[cursor[slices[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+// 只接受真正的bool参数：无捕获lambda可以经函数指针隐式转换成bool，
+// 不加限制时传入weigher会误匹配到带bool参数的构造函数
+template<typename B>
+using EnableIfBool = std::enable_if_t<std::is_same_v<B, bool>, int>;
+
+// 估算每次堆分配的额外开销(glibc malloc的块头与对齐)
+constexpr size_t kAllocOverhead = 16;
+
+// std::unordered_map一个节点的估算开销：next指针+键值对+分配开销，再加一个桶指针(负载因子约为1)
+template<typename Key, typename Mapped>
+constexpr size_t hashNodeBytes()
+{
+    return sizeof(void*) + sizeof(std::pair<const Key, Mapped>) + kAllocOverhead + sizeof(void*);
+}
+
+// std::list一个节点的估算开销：前后指针+元素+分配开销
+template<typename T>
+constexpr size_t listNodeBytes()
+{
+    return 2 * sizeof(void*) + sizeof(T) + kAllocOverhead;
+}
+
+// 容量记账：不设weigher时每个条目计1，即按条目数限制；
+// 设了weigher时每个条目计 weigher(key, value) + entryOverhead(节点、索引槽位、链表指针等固定开销)，按字节限制
+// 分片缓存可以让各分片共享一个全局计数(share)，此时是否超出以全局总量为准
+template<typename Key, typename Value>
+class WeightBudget
+{
+public:
+    explicit WeightBudget(size_t capacity, Weigher<Key, Value> weigher = nullptr, size_t entryOverhead = 0)
+        : capacity_(capacity)
+        , weight_(0)
+        , entryOverhead_(entryOverhead)
+        , weigher_(std::move(weigher))
+        , shared_(nullptr)
+    {}
+
+    size_t charge(const Key& key, const Value& value) const
+    {
+        return weigher_ ? weigher_(key, value) + entryOverhead_ : 1;
+    }
+
+    void add(size_t charge)
+    {
+        weight_ += charge;
+        if (shared_) shared_->fetch_add(charge, std::memory_order_relaxed);
+    }
+
+    void sub(size_t charge)
+    {
+        weight_ -= charge;
+        if (shared_) shared_->fetch_sub(charge, std::memory_order_relaxed);
+    }
+
+    // 是否超出预算，超出时调用方应继续淘汰
+    bool overflow() const
+    {
+        return (shared_ ? shared_->load(std::memory_order_relaxed) : weight_) > capacity_;
+    }
+
+    // 单个条目本身就超过整个预算时不应放入缓存
+    bool fits(size_t charge) const { return charge <= capacity_; }
+
+    void share(std::atomic<size_t>* total) { shared_ = total; }
+    void reset() { sub(weight_); }
+
+    bool   weighted() const { return static_cast<bool>(weigher_); }
+    size_t capacity() const { return capacity_; }
+    size_t weight() const { return weight_; }
+    void   setCapacity(size_t capacity) { capacity_ = capacity; }
+
+private:
+    size_t               capacity_;
+    size_t               weight_; // 本实例的总权重
+    size_t               entryOverhead_;
+    Weigher<Key, Value>  weigher_;
+    std::atomic<size_t>* shared_; // 分片共享的全局总权重，可为空
+};
+
+// 对象池：按块向系统申请内存，释放的对象进入空闲链表复用，对象地址在生命期内不变
+// 稳态下create/destroy都不触及malloc；非线程安全，由使用方的锁保护
+// 池销毁时只归还内存，不析构仍存活的对象，使用方需先destroy全部对象
+template<typename T>
+class ObjectPool
+{
+public:
+    ObjectPool()
+        : free_(nullptr)
+        , used_(kChunkSize)
+    {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* create(Args&&... args)
+    {
+        Slot* slot = acquire();
+        try
+        {
+            return new (slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            release(slot);
+            throw;
+        }
+    }
+
+    void destroy(T* object)
+    {
+        object->~T();
+        release(reinterpret_cast<Slot*>(object));
+    }
+
+private:
+    static constexpr size_t kChunkSize = 256;
+
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    Slot* acquire()
+    {
+        if (free_)
+        {
+            Slot* slot = free_;
+            free_ = slot->next;
+            return slot;
+        }
+        if (used_ == kChunkSize)
+        {
+            chunks_.emplace_back(new Slot[kChunkSize]);
+            used_ = 0;
+        }
+        return &chunks_.back()[used_++];
+    }
+
+    void release(Slot* slot)
+    {
+        slot->next = free_;
+        free_ = slot;
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> chunks_;
+    Slot*                                free_; // 空闲链表
+    size_t                               used_; // 最后一块中已经切出的对象数
+};
+
+// 当前线程的条带号(已打散)，用于把线程分散到按线程分条的缓冲区/计数器上
+inline size_t threadStripe()
+{
+    static thread_local size_t stripe =
+        static_cast<size_t>(mixHash(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+    return stripe;
+}
+
+// 用构造参数给已存在的value赋值：单个同类型参数时直接拷贝/移动赋值，否则先就地构造再移动
+template<typename Value, typename... Args>
+inline void assignValue(Value& dst, Args&&... args)
+{
+    if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, Value> && ...))
+    {
+        dst = (std::forward<Args>(args), ...);
+    }
+    else
+    {
+        dst = Value(std::forward<Args>(args)...);
+    }
+}
+
+} // namespace detail
+
+} // namespace Cache
@@ -0,0 +1,600 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// CLOCK缓存：命中只置位原子引用位，读路径只持有共享锁；
+// 淘汰时由时钟指针环形扫描，引用位为1的清零后跳过，遇到为0的即淘汰
+
+template<typename Key, typename Value>
+class ClockCache : public CachePolicy<Key, Value>
+{
+public:
+    explicit ClockCache(int capacity)
+        : capacity_(capacity > 0 ? static_cast<uint32_t>(capacity) : 0)
+        , hand_(0)
+        , slots_(capacity_)
+    {
+        freeSlots_.reserve(capacity_);
+        for (uint32_t i = capacity_; i > 0; --i)
+        {
+            freeSlots_.push_back(i - 1);
+        }
+    }
+
+    ~ClockCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            Slot& slot = slots_[it->second];
+            stats_.add(detail::Stat::Update);
+            detail::assignValue(slot.value, std::forward<Args>(args)...);
+            slot.referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+        insertNew(key, std::forward<Args>(args)...);
+    }
+
+    // 仅在key不存在时插入 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        if (index_.find(key) != index_.end()) return false;
+        insertNew(key, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中时只在共享锁内读取并置位引用位，不修改任何链接结构
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lockShared(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            stats_.addConcurrent(detail::Stat::Miss);
+            return false;
+        }
+
+        stats_.addConcurrent(detail::Stat::Hit);
+        Slot& slot = slots_[it->second];
+        // 已置位时不再写，避免热点key所在缓存行被反复写脏
+        if (!slot.referenced.load(std::memory_order_relaxed))
+        {
+            slot.referenced.store(true, std::memory_order_relaxed);
+        }
+        visitor(static_cast<const Value&>(slot.value));
+        return true;
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+
+        uint32_t idx = it->second;
+        index_.erase(it);
+        slots_[idx].value = Value();
+        slots_[idx].used = false;
+        freeSlots_.push_back(idx);
+    }
+
+    // 命中在共享锁内计数，多个读线程落在各自的计数条上
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    struct Slot
+    {
+        Key               key{};
+        Value             value{};
+        std::atomic<bool> referenced{false}; // 引用位，命中时置位
+        bool              used = false;
+    };
+
+    template<typename... Args>
+    void insertNew(const Key& key, Args&&... args)
+    {
+        uint32_t idx;
+        if (!freeSlots_.empty())
+        {
+            idx = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        else
+        {
+            idx = sweep();
+            index_.erase(slots_[idx].key);
+            stats_.add(detail::Stat::Eviction);
+        }
+        stats_.add(detail::Stat::Insert);
+
+        Slot& slot = slots_[idx];
+        slot.key = key;
+        detail::assignValue(slot.value, std::forward<Args>(args)...);
+        slot.referenced.store(false, std::memory_order_relaxed);
+        slot.used = true;
+        index_.emplace(key, idx);
+    }
+
+    // 转动时钟指针直到找到引用位为0的槽位，返回该槽位
+    uint32_t sweep()
+    {
+        while (true)
+        {
+            Slot& slot = slots_[hand_];
+            uint32_t current = hand_;
+            hand_ = (hand_ + 1 == capacity_) ? 0 : hand_ + 1;
+            if (!slot.used) continue;
+            if (slot.referenced.load(std::memory_order_relaxed))
+            {
+                slot.referenced.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            return current;
+        }
+    }
+
+private:
+    uint32_t                            capacity_;
+    uint32_t                            hand_;      // 时钟指针
+    std::vector<Slot>                   slots_;     // 环形槽位
+    std::vector<uint32_t>               freeSlots_; // 空闲槽位
+    std::unordered_map<Key, uint32_t>   index_;     // key -> 槽位下标
+    std::shared_mutex                   mutex_;     // 读共享、写独占
+    detail::StatsCounter                stats_;
+};
+
+// CLOCK-Pro缓存(Jiang, Chen, Zhang 2005)
+// 一个环上同时存放热页(hot)、冷页(cold)以及已淘汰但仍在测试期的非驻留冷页(test)。
+// 新写入的页是处于测试期的冷页；每个驻留冷页带一个测试期标记，三个指针分别负责：
+// - cold指针：被引用过的冷页若在测试期内则升级为热页，否则开始新的测试期；两者都移到环头。
+//   未被引用的冷页被淘汰，在测试期内的保留key成为测试页，否则整个移出环
+// - hot指针：热页被引用过则清除引用位，否则降级为(不在测试期的)冷页；途经的冷页结束测试期，
+//   途经的测试页被回收
+// - test指针：测试页超过capacity个时运行，结束途经冷页的测试期并回收测试页
+// 冷页目标容量coldTarget_自适应：测试期内的冷页被再次访问(读或写到测试页)时加一，
+// 测试期结束仍未被访问时减一，从而在扫描类访问下保护热数据。命中同样只置位原子引用位。
+
+template<typename Key, typename Value>
+class ClockProCache : public CachePolicy<Key, Value>
+{
+public:
+    explicit ClockProCache(int capacity)
+        : capacity_(capacity > 0 ? static_cast<uint32_t>(capacity) : 0)
+        , coldTarget_(capacity_)
+        , countHot_(0)
+        , countCold_(0)
+        , countTest_(0)
+        , handHot_(kNil)
+        , handCold_(kNil)
+        , handTest_(kNil)
+        , nodes_(capacity_ * 2 + 1)
+    {
+        // 驻留页最多capacity个，测试页最多capacity个，再留一个插入时的余量
+        freeNodes_.reserve(nodes_.size());
+        for (uint32_t i = static_cast<uint32_t>(nodes_.size()); i > 0; --i)
+        {
+            freeNodes_.push_back(i - 1);
+        }
+    }
+
+    ~ClockProCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            // 新页以冷页身份进入
+            stats_.add(detail::Stat::Insert);
+            addNode(key, PageType::Cold, std::forward<Args>(args)...);
+            ++countCold_;
+            return;
+        }
+
+        Node& node = nodes_[it->second];
+        if (node.type != PageType::Test)
+        {
+            stats_.add(detail::Stat::Update);
+            detail::assignValue(node.value, std::forward<Args>(args)...);
+            node.referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        // 测试期内再次访问：说明冷页容量不足，扩大冷页目标，并以热页身份重新驻留
+        // 读到测试页时已经计过一次(引用位已置位)，这里不再重复
+        if (!node.referenced.load(std::memory_order_relaxed))
+            noteTestHit();
+        stats_.add(detail::Stat::Insert);
+        --countTest_;
+        removeNode(it->second);
+        addNode(key, PageType::Hot, std::forward<Args>(args)...);
+        ++countHot_;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lockShared(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            stats_.addConcurrent(detail::Stat::Miss);
+            return false;
+        }
+        if (nodes_[it->second].type == PageType::Test)
+        {
+            // 非驻留页视为未命中，但测试期内的访问要计入冷页目标的调整，需要独占锁
+            stats_.addConcurrent(detail::Stat::Miss);
+            lock.unlock();
+            recordTestAccess(key);
+            return false;
+        }
+
+        stats_.addConcurrent(detail::Stat::Hit);
+        Node& node = nodes_[it->second];
+
+        if (!node.referenced.load(std::memory_order_relaxed))
+        {
+            node.referenced.store(true, std::memory_order_relaxed);
+        }
+        visitor(static_cast<const Value&>(node.value));
+        return true;
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+
+        switch (nodes_[it->second].type)
+        {
+            case PageType::Hot:  --countHot_;  break;
+            case PageType::Cold: --countCold_; break;
+            case PageType::Test: --countTest_; break;
+        }
+        removeNode(it->second);
+    }
+
+    // 访问到测试页计为ghostHits(同一测试页先读后写只计一次)
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    enum class PageType : uint8_t { Hot, Cold, Test };
+
+    struct Node
+    {
+        Key               key{};
+        Value             value{};
+        uint32_t          prev = kNil;
+        uint32_t          next = kNil;
+        PageType          type = PageType::Cold;
+        bool              inTest = false;   // 驻留冷页是否在测试期内(测试页总在测试期内)
+        std::atomic<bool> referenced{false}; // 测试页上表示测试期内已被读到过
+    };
+
+    // 在hot指针之前(即环的"头部")插入新节点，插入前先腾出驻留空间
+    template<typename... Args>
+    void addNode(const Key& key, PageType type, Args&&... args)
+    {
+        evict();
+
+        uint32_t idx = freeNodes_.back();
+        freeNodes_.pop_back();
+        Node& node = nodes_[idx];
+        node.key = key;
+        detail::assignValue(node.value, std::forward<Args>(args)...);
+        node.type = type;
+        node.inTest = type == PageType::Cold;
+        node.referenced.store(false, std::memory_order_relaxed);
+
+        linkAtHead(idx);
+        index_.emplace(key, idx);
+    }
+
+    // 把节点链到hot指针之前，即各指针最晚扫到的位置
+    void linkAtHead(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        if (handHot_ == kNil)
+        {
+            node.prev = node.next = idx;
+            handHot_ = handCold_ = handTest_ = idx;
+        }
+        else
+        {
+            uint32_t before = nodes_[handHot_].prev;
+            node.prev = before;
+            node.next = handHot_;
+            nodes_[before].next = idx;
+            nodes_[handHot_].prev = idx;
+        }
+    }
+
+    // 把环上的节点挪到环头，指向它的指针先前移
+    void moveToHead(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        if (node.next == idx) return;
+        if (handHot_ == idx) handHot_ = node.next;
+        if (handCold_ == idx) handCold_ = node.next;
+        if (handTest_ == idx) handTest_ = node.next;
+        nodes_[node.prev].next = node.next;
+        nodes_[node.next].prev = node.prev;
+        linkAtHead(idx);
+    }
+
+    // 读到测试页：在独占锁内重新查找，期间它可能已被回收或重新写入
+    void recordTestAccess(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+        Node& node = nodes_[it->second];
+        if (node.type != PageType::Test || node.referenced.load(std::memory_order_relaxed)) return;
+        node.referenced.store(true, std::memory_order_relaxed);
+        noteTestHit();
+    }
+
+    // 测试期内的冷页被再次访问：扩大冷页目标
+    void noteTestHit()
+    {
+        stats_.add(detail::Stat::GhostHit);
+        if (coldTarget_ < capacity_) ++coldTarget_;
+    }
+
+    // 测试期结束仍未被访问：缩小冷页目标
+    void endTest(Node& node)
+    {
+        node.inTest = false;
+        if (coldTarget_ > 1) --coldTarget_;
+    }
+
+    // 从环上摘除节点，如有指针正指向它则先前移
+    void removeNode(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        if (node.next == idx)
+        {
+            handHot_ = handCold_ = handTest_ = kNil;
+        }
+        else
+        {
+            if (handHot_ == idx) handHot_ = node.next;
+            if (handCold_ == idx) handCold_ = node.next;
+            if (handTest_ == idx) handTest_ = node.next;
+            nodes_[node.prev].next = node.next;
+            nodes_[node.next].prev = node.prev;
+        }
+        index_.erase(node.key);
+        node.value = Value();
+        node.prev = node.next = kNil;
+        freeNodes_.push_back(idx);
+    }
+
+    void evict()
+    {
+        while (countHot_ + countCold_ >= capacity_)
+        {
+            runHandCold();
+            while (countHot_ > capacity_ - coldTarget_)
+            {
+                runHandHot();
+            }
+        }
+    }
+
+    void runHandCold()
+    {
+        uint32_t idx = handCold_;
+        Node& node = nodes_[idx];
+        if (node.type != PageType::Cold)
+        {
+            handCold_ = node.next;
+            return;
+        }
+
+        if (node.referenced.load(std::memory_order_relaxed))
+        {
+            node.referenced.store(false, std::memory_order_relaxed);
+            if (node.inTest)
+            {
+                // 测试期内被引用，升级为热页
+                node.type = PageType::Hot;
+                node.inTest = false;
+                --countCold_;
+                ++countHot_;
+            }
+            else
+            {
+                // 测试期外被引用，仍是冷页，开始新的测试期
+                node.inTest = true;
+            }
+            moveToHead(idx); // cold指针随之前移
+            return;
+        }
+
+        stats_.add(detail::Stat::Eviction);
+        --countCold_;
+        if (!node.inTest)
+        {
+            // 不在测试期：整个移出环
+            removeNode(idx);
+            return;
+        }
+        // 淘汰驻留数据，保留key作为测试页
+        node.type = PageType::Test;
+        node.value = Value();
+        ++countTest_;
+        handCold_ = node.next;
+        while (countTest_ > capacity_)
+        {
+            runHandTest();
+        }
+    }
+
+    // hot指针：热页被引用过则清除引用位，否则降级为不在测试期的冷页；
+    // 途经的冷页结束测试期，途经的测试页被回收
+    void runHandHot()
+    {
+        uint32_t idx = handHot_;
+        Node& node = nodes_[idx];
+        if (node.type == PageType::Hot)
+        {
+            if (node.referenced.load(std::memory_order_relaxed))
+            {
+                node.referenced.store(false, std::memory_order_relaxed);
+            }
+            else
+            {
+                node.type = PageType::Cold;
+                node.inTest = false;
+                --countHot_;
+                ++countCold_;
+            }
+        }
+        else if (node.type == PageType::Cold)
+        {
+            if (node.inTest) endTest(node);
+        }
+        else
+        {
+            expireTestPage(idx);
+        }
+        if (handHot_ == idx) handHot_ = nodes_[idx].next;
+    }
+
+    // test指针：结束途经冷页的测试期，回收测试页
+    void runHandTest()
+    {
+        uint32_t idx = handTest_;
+        if (idx == kNil) return;
+        Node& node = nodes_[idx];
+        if (node.type == PageType::Test)
+        {
+            expireTestPage(idx);
+        }
+        else if (node.type == PageType::Cold && node.inTest)
+        {
+            endTest(node);
+        }
+        if (handTest_ == idx) handTest_ = nodes_[idx].next;
+    }
+
+    // 回收测试页；测试期内被读到过的已经扩大过冷页目标，不再缩小
+    // removeNode会把指向它的指针移到下一个节点
+    void expireTestPage(uint32_t idx)
+    {
+        bool accessed = nodes_[idx].referenced.load(std::memory_order_relaxed);
+        --countTest_;
+        removeNode(idx);
+        if (!accessed && coldTarget_ > 1) --coldTarget_;
+    }
+
+private:
+    uint32_t                            capacity_;
+    uint32_t                            coldTarget_; // 冷页目标容量(自适应)
+    uint32_t                            countHot_;
+    uint32_t                            countCold_;
+    uint32_t                            countTest_;
+    uint32_t                            handHot_;
+    uint32_t                            handCold_;
+    uint32_t                            handTest_;
+    std::vector<Node>                   nodes_;     // 节点池
+    std::vector<uint32_t>               freeNodes_;
+    std::unordered_map<Key, uint32_t>   index_;     // key -> 节点下标(含测试页)
+    std::shared_mutex                   mutex_;
+    detail::StatsCounter                stats_;
+};
+
+} // namespace Cache
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// 紧凑存储的LFU缓存，面向条目多、单条目小的场景
+// 所有节点在构造时一次性分配(容量个)，key/value内联在节点里，节点之间用32位下标链接，
+// 哈希桶的头也放在节点数组里(同SlabLruCache)；访问频次是一个8位的对数(Morris)计数器，
+// 计数器的每一级对应一个频次等级链表，命中时以概率 base^-level 升一级，
+// 淘汰时取最低非空等级的队首(同等级中最久未访问的)，用位图找最低非空等级，put/get都是O(1)
+// counterBits(4~8)限制计数器的级数，base按"最高一级约对应kMaxEstimate次访问"选取：
+// 位数越少计数越粗，但频次上限不变；每条目除key/value外只有4个下标和1个字节的计数器
+template<typename Key, typename Value>
+class CompactLfuCache : public CachePolicy<Key, Value>
+{
+public:
+    // 最高一级计数器大约对应的访问次数
+    static constexpr double kMaxEstimate = 1000000.0;
+
+    explicit CompactLfuCache(int capacity, int counterBits = 8)
+        : capacity_(capacity > 0 ? static_cast<uint32_t>(capacity) : 0)
+        , size_(0)
+        , maxLevel_((1u << std::min(std::max(counterBits, 4), 8)) - 1)
+        , freeHead_(kNil)
+        , rng_(0x9e3779b9u)
+        , nodes_(capacity_)
+    {
+        // 空闲链表穿在next上
+        for (uint32_t i = 0; i < capacity_; ++i)
+        {
+            nodes_[i].next = (i + 1 < capacity_) ? i + 1 : kNil;
+        }
+        freeHead_ = capacity_ > 0 ? 0 : kNil;
+        levelHead_.fill(kNil);
+        levelTail_.fill(kNil);
+        levelMask_.fill(0);
+        initCounter();
+    }
+
+    ~CompactLfuCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    // 就地给节点的value赋值，已存在则更新并计一次访问
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        uint32_t idx = findInBucket(key, bucket);
+        if (idx != kNil)
+        {
+            stats_.add(detail::Stat::Update);
+            detail::assignValue(nodes_[idx].value, std::forward<Args>(args)...);
+            touch(idx);
+            return;
+        }
+        insertNew(key, bucket, std::forward<Args>(args)...);
+    }
+
+    // 仅在key不存在时插入 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        if (findInBucket(key, bucket) != kNil) return false;
+        insertNew(key, bucket, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = findInBucket(key, bucketOf(key));
+        if (idx == kNil)
+        {
+            stats_.add(detail::Stat::Miss);
+            return Value{};
+        }
+
+        stats_.add(detail::Stat::Hit);
+        touch(idx);
+        return nodes_[idx].value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = findInBucket(key, bucketOf(key));
+        if (idx == kNil)
+        {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+
+        stats_.add(detail::Stat::Hit);
+        touch(idx);
+        visitor(static_cast<const Value&>(nodes_[idx].value));
+        return true;
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        uint32_t idx = findInBucket(key, bucket);
+        if (idx == kNil) return;
+
+        unlinkFromBucket(idx, bucket);
+        unlinkFromLevel(idx);
+        nodes_[idx].value = Value(); // 释放value持有的资源
+        nodes_[idx].next = freeHead_;
+        freeHead_ = idx;
+        --size_;
+    }
+
+    // 按计数器等级估算的访问次数 | key不存在时返回false
+    bool frequency(const Key& key, long long& freq)
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = findInBucket(key, bucketOf(key));
+        if (idx == kNil) return false;
+
+        freq = estimate_[nodes_[idx].level];
+        return true;
+    }
+
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        return size_;
+    }
+
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint32_t kLevels = 256;
+
+    struct Node
+    {
+        Key      key{};
+        Value    value{};
+        uint32_t prev = kNil;       // 等级链表前驱
+        uint32_t next = kNil;       // 等级链表后继 / 空闲链表
+        uint32_t hashNext = kNil;   // 同一哈希桶中的下一个节点
+        uint32_t bucketHead = kNil; // 以本下标为桶号的哈希桶的头节点
+        uint8_t  level = 0;         // 对数计数器，0表示访问过1次
+    };
+
+    // 选取base使最高一级约对应kMaxEstimate次访问，并预先算好每一级的升级概率与估算次数
+    // 第c级估算次数 n(c) = 1 + (base^c - 1) / (base - 1)，即每次升级的期望访问数依次乘以base
+    void initCounter()
+    {
+        double lo = 1.0 + 1e-9;
+        double hi = 16.0;
+        for (int i = 0; i < 100; ++i)
+        {
+            double mid = (lo + hi) / 2;
+            double n = 1.0 + (std::pow(mid, maxLevel_) - 1.0) / (mid - 1.0);
+            if (n < kMaxEstimate) lo = mid;
+            else hi = mid;
+        }
+        double base = hi;
+
+        double p = 1.0;
+        double n = 1.0;
+        double step = 1.0;
+        for (uint32_t c = 0; c < kLevels; ++c)
+        {
+            // 以32位随机数比较：threshold = p * 2^32，第0级必定升级
+            threshold_[c] = c < maxLevel_ ? static_cast<uint64_t>(p * 4294967296.0) : 0;
+            estimate_[c] = static_cast<long long>(n + 0.5);
+            n += step;
+            step *= base;
+            p /= base;
+        }
+    }
+
+    uint32_t nextRandom() // xorshift32
+    {
+        rng_ ^= rng_ << 13;
+        rng_ ^= rng_ >> 17;
+        rng_ ^= rng_ << 5;
+        return rng_;
+    }
+
+    template<typename... Args>
+    void insertNew(const Key& key, uint32_t bucket, Args&&... args)
+    {
+        uint32_t idx;
+        if (freeHead_ == kNil)
+        {
+            // 满了则复用最低等级中最久未访问的节点
+            stats_.add(detail::Stat::Eviction);
+            idx = levelHead_[lowestLevel()];
+            unlinkFromBucket(idx, bucketOf(nodes_[idx].key));
+            unlinkFromLevel(idx);
+        }
+        else
+        {
+            idx = freeHead_;
+            freeHead_ = nodes_[idx].next;
+            ++size_;
+        }
+
+        stats_.add(detail::Stat::Insert);
+        Node& node = nodes_[idx];
+        node.key = key;
+        detail::assignValue(node.value, std::forward<Args>(args)...);
+        node.level = 0;
+        node.hashNext = nodes_[bucket].bucketHead;
+        nodes_[bucket].bucketHead = idx;
+        linkToLevel(idx);
+    }
+
+    // 命中：按概率升一级，并挪到所在等级的队尾
+    void touch(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        unlinkFromLevel(idx);
+        if (nextRandom() < threshold_[node.level])
+        {
+            ++node.level;
+        }
+        linkToLevel(idx);
+    }
+
+    uint32_t lowestLevel() const
+    {
+        for (uint32_t w = 0; w < levelMask_.size(); ++w)
+        {
+            if (levelMask_[w])
+            {
+                return (w << 6) + detail::lowestBit(levelMask_[w]);
+            }
+        }
+        return 0;
+    }
+
+    uint32_t bucketOf(const Key& key) const
+    {
+        return detail::fastRange(detail::hashKey(key), capacity_);
+    }
+
+    uint32_t findInBucket(const Key& key, uint32_t bucket) const
+    {
+        if (capacity_ == 0) return kNil;
+        uint32_t idx = nodes_[bucket].bucketHead;
+        while (idx != kNil && !(nodes_[idx].key == key))
+        {
+            idx = nodes_[idx].hashNext;
+        }
+        return idx;
+    }
+
+    void unlinkFromBucket(uint32_t idx, uint32_t bucket)
+    {
+        uint32_t* link = &nodes_[bucket].bucketHead;
+        while (*link != idx)
+        {
+            link = &nodes_[*link].hashNext;
+        }
+        *link = nodes_[idx].hashNext;
+        nodes_[idx].hashNext = kNil;
+    }
+
+    void unlinkFromLevel(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        uint32_t level = node.level;
+        if (node.prev != kNil) nodes_[node.prev].next = node.next;
+        else levelHead_[level] = node.next;
+        if (node.next != kNil) nodes_[node.next].prev = node.prev;
+        else levelTail_[level] = node.prev;
+        if (levelHead_[level] == kNil)
+        {
+            levelMask_[level >> 6] &= ~(1ULL << (level & 63));
+        }
+        node.prev = node.next = kNil;
+    }
+
+    void linkToLevel(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        uint32_t level = node.level;
+        node.next = kNil;
+        node.prev = levelTail_[level];
+        if (levelTail_[level] != kNil) nodes_[levelTail_[level]].next = idx;
+        else levelHead_[level] = idx;
+        levelTail_[level] = idx;
+        levelMask_[level >> 6] |= 1ULL << (level & 63);
+    }
+
+private:
+    uint32_t                           capacity_;
+    uint32_t                           size_;
+    uint32_t                           maxLevel_;  // 计数器的最高一级
+    uint32_t                           freeHead_;  // 空闲节点链表
+    uint32_t                           rng_;       // 概率升级用的随机数状态
+    std::vector<Node>                  nodes_;     // 节点slab，同时承载哈希桶头
+    std::array<uint32_t, kLevels>      levelHead_; // 各等级最久未访问的节点
+    std::array<uint32_t, kLevels>      levelTail_; // 各等级最近访问的节点
+    std::array<uint64_t, kLevels / 64> levelMask_; // 非空等级的位图
+    std::array<uint64_t, kLevels>      threshold_; // 各等级的升级概率 * 2^32
+    std::array<long long, kLevels>     estimate_;  // 各等级对应的估算访问次数
+    std::mutex                         mutex_;
+    detail::StatsCounter               stats_;
+};
+
+} // namespace Cache
@@ -1,247 +1,608 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+#include "MissRatioCurve.h"
+#include "TimerWheel.h"
 
 namespace Cache
 {
 
-template<typename Key, typename Value> class LFUCache;
+// 访问频次的老化方式：平均访问频次超过上限时，所有条目的频次减去 maxAverageNum / 2(最小为1)
+// Eager: 当场改写每个频次桶，降到1的桶逐个结点并入第一个桶，最坏需要遍历几乎所有结点
+// Lazy:  只累加一个全局的衰减量，频次桶记录未衰减的原始频次，有效频次 = max(1, 原始频次 - 衰减量)；
+//        原始频次不超过(衰减量+1)的桶有效频次都是1，它们是桶链表的一段前缀，按原始频次从小到大淘汰，
+//        不再逐个改写结点，任何一次操作都不会做O(n)的工作；平均访问频次按衰减量估算
+enum class LfuAging
+{
+    Eager,
+    Lazy
+};
 
-template<typename Key, typename Value>
-class FreqList
+// 经典O(1) LFU：同一访问频次的结点串成一个频次桶，频次桶按频次从小到大串成双向链表，
+// 命中时结点只需挪到相邻的(频次+1)桶，淘汰时直接取第一个桶(最小频次)的队首(同频次中最早进入的)
+// 结点与频次桶都是侵入式的原始指针链接，由对象池分配并复用，稳态下put/get不再有堆分配和引用计数
+// 传入weigher时容量按字节计算，每个条目计 weigher(key, value) + kEntryOverhead，淘汰直到总量不超出预算
+// 支持按条目和默认TTL：过期的条目立即按未命中处理，由时间轮在后续的操作中回收
+template <typename Key, typename Value>
+class LFUCache : public CachePolicy<Key, Value>
 {
 private:
-    struct Node
-    {
-        int freq; // 访问频次
-        Key key;
-        Value value;
-        std::weak_ptr<Node> pre; // 上一结点改为weak_ptr打破循环引用
-        std::shared_ptr<Node> next;
-
-        Node() 
-        : freq(1), next(nullptr) {}
-        Node(Key key, Value value) 
-        : freq(1), key(key), value(value), next(nullptr) {}
+    struct FreqBucket;
+
+    struct Node : TimerLink
+    {
+        // 直接用参数就地构造value，避免先拷贝再赋值
+        template<typename... Args>
+        explicit Node(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...) {}
+
+        Key         key;
+        Value       value;
+        uint64_t    expireAt = 0;       // 过期时刻(CoarseClock毫秒)，0表示永不过期，非0时结点挂在时间轮上
+        Node*       pre = nullptr;      // 同一频次桶中的上一结点
+        Node*       next = nullptr;     // 同一频次桶中的下一结点
+        FreqBucket* bucket = nullptr;   // 所在的频次桶，结点的访问频次即bucket->freq
     };
 
-    using NodePtr = std::shared_ptr<Node>;
-    int freq_; // 访问频率
-    NodePtr head_; // 假头结点
-    NodePtr tail_; // 假尾结点
+    // 频次桶：桶内按进入的先后排列，队首最早进入，最先被淘汰
+    struct FreqBucket
+    {
+        explicit FreqBucket(long long f) : freq(f) {}
+
+        long long   freq;               // 访问频次(Lazy老化时为未衰减的原始频次)
+        Node*       head = nullptr;
+        Node*       tail = nullptr;
+        FreqBucket* pre = nullptr;      // 频次更小的桶
+        FreqBucket* next = nullptr;     // 频次更大的桶
+    };
 
 public:
-    explicit FreqList(int n) 
-     : freq_(n) 
+    using NodeMap = std::unordered_map<Key, Node*>;
+
+    // 每个条目的固定开销估算：池中的结点 + 索引节点(频次桶数量远少于条目数，忽略)
+    static constexpr size_t kEntryOverhead = sizeof(Node) + detail::hashNodeBytes<Key, Node*>();
+
+    LFUCache(int capacity, int maxAverageNum = 1000000, LfuAging aging = LfuAging::Eager)
+    : LFUCache(static_cast<size_t>(capacity > 0 ? capacity : 0), nullptr, maxAverageNum, aging)
+    {}
+
+    // 按字节限制容量：maxWeight为字节预算
+    LFUCache(size_t maxWeight, Weigher<Key, Value> weigher, int maxAverageNum = 1000000,
+             LfuAging aging = LfuAging::Eager)
+    : budget_(maxWeight, std::move(weigher), kEntryOverhead), maxAverageNum_(maxAverageNum),
+      curAverageNum_(0), curTotalNum_(0), aging_(aging), decay_(0), freqHead_(nullptr),
+      clampedTail_(nullptr)
+    {}
+
+    ~LFUCache() override
+    {
+        purge();
+    }
+
+    void put(const Key& key, const Value& value) override
     {
-      head_ = std::make_shared<Node>();
-      tail_ = std::make_shared<Node>();
-      head_->next = tail_;
-      tail_->pre = head_;
+        emplace(key, value);
     }
 
-    bool isEmpty() const
+    void put(const Key& key, Value&& value) override
     {
-      return head_->next == tail_;
+        emplace(key, std::move(value));
     }
 
-    // 添加结点管理方法
-    void addNode(NodePtr node) 
+    // 就地构造value，已存在则用参数重新赋值
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
     {
-        if (!node || !head_ || !tail_) 
+        if (budget_.capacity() == 0)
             return;
 
-        node->pre = tail_->pre;
-        node->next = tail_;
-        tail_->pre.lock()->next = node; // 使用lock()获取shared_ptr
-        tail_->pre = node;
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        emplaceLocked(key, CoarseClock::expireAt(defaultTtl_), std::forward<Args>(args)...);
     }
 
-    void removeNode(NodePtr node)
+    // 写入并指定该条目的TTL，ttl不大于0表示永不过期
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
     {
-        if (!node || !head_ || !tail_)
-            return;
-        if (node->pre.expired() || !node->next) 
+        if (budget_.capacity() == 0)
             return;
 
-        auto pre = node->pre.lock(); // 使用lock()获取shared_ptr
-        pre->next = node->next;
-        node->next->pre = pre;
-        node->next = nullptr; // 确保显式置空next指针，彻底断开节点与链表的连接
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        emplaceLocked(key, CoarseClock::expireAt(ttl), std::forward<V>(value));
     }
 
-    NodePtr getFirstNode() const { return head_->next; }
-    
-    friend class LFUCache<Key, Value>;
-};
+    // 之后写入的条目默认的TTL，不大于0表示永不过期(默认)
+    void setDefaultTtl(std::chrono::milliseconds ttl)
+    {
+        auto lock = stats_.lock(mutex_);
+        defaultTtl_ = ttl;
+    }
 
-template <typename Key, typename Value>
-class LFUCache : public CachePolicy<Key, Value>
-{
-public:
-    using Node = typename FreqList<Key, Value>::Node;
-    using NodePtr = std::shared_ptr<Node>;
-    using NodeMap = std::unordered_map<Key, NodePtr>;
+    // 仅在key不存在时插入 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (budget_.capacity() == 0)
+            return false;
 
-    LFUCache(int capacity, int maxAverageNum = 1000000)
-    : capacity_(capacity), minFreq_(INT8_MAX), maxAverageNum_(maxAverageNum),
-      curAverageNum_(0), curTotalNum_(0) 
-    {}
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        auto it = nodeMap_.find(key);
+        if (it != nodeMap_.end())
+        {
+            if (!expired(*it->second))
+                return false;
+            removeInternal(it->second); // 已过期但还没回收的条目视为不存在
+        }
 
-    ~LFUCache() override = default;
+        putInternal(key, CoarseClock::expireAt(defaultTtl_), std::forward<Args>(args)...);
+        return true;
+    }
 
-    void put(Key key, Value value) override
+    // value值为传出参数
+    bool get(const Key& key, Value& value) override
     {
-        if (capacity_ == 0)
-            return;
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+    Value get(const Key& key) override
+    {
+        Value value{};
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中时在锁内以只读引用调用visitor，不拷贝value
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
         auto it = nodeMap_.find(key);
-        if (it != nodeMap_.end())
+        if (it == nodeMap_.end())
+        {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+
+        Node* node = it->second;
+        if (expired(*node))
         {
-            // 重置其value值
-            it->second->value = value;
-            // 找到了直接调整就好了，不用再去get中再找一遍，但其实影响不大
-            getInternal(it->second, value);
+            removeInternal(node);
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+
+        stats_.add(detail::Stat::Hit);
+        getInternal(node);
+        visitor(static_cast<const Value&>(node->value));
+        return true;
+    }
+
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found) override
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        return visitBatch(keys.size(),
+                          [&keys](size_t i) -> const Key& { return keys[i]; },
+                          [&](size_t i, const Value& v) { values[i] = v; found[i] = true; });
+    }
+
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values) override
+    {
+        putBatch(std::min(keys.size(), values.size()),
+                 [&keys](size_t i) -> const Key& { return keys[i]; },
+                 [&values](size_t i) -> const Value& { return values[i]; });
+    }
+
+    // 批量访问的通用形式：count个key由keyAt(i)给出，整批只加一次锁，命中时调用visitor(i, value)
+    // 每kBatchChunk个key先集中查索引并预取结点，再统一调整频次桶 | 返回命中个数
+    template<typename KeyAt, typename Visitor>
+    size_t visitBatch(size_t count, KeyAt&& keyAt, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        size_t hits = 0;
+        std::array<Node*, kBatchChunk> nodes;
+        for (size_t base = 0; base < count; base += kBatchChunk)
+        {
+            size_t n = std::min(kBatchChunk, count - base);
+            for (size_t j = 0; j < n; ++j)
+            {
+                auto it = nodeMap_.find(keyAt(base + j));
+                nodes[j] = it != nodeMap_.end() ? it->second : nullptr;
+                if (nodes[j])
+                    detail::prefetch(nodes[j]);
+            }
+            for (size_t j = 0; j < n; ++j)
+            {
+                // 过期的条目按未命中处理，留给时间轮回收，避免同一批中重复的key访问已释放的结点
+                if (!nodes[j] || expired(*nodes[j]))
+                    continue;
+                getInternal(nodes[j]);
+                visitor(base + j, static_cast<const Value&>(nodes[j]->value));
+                ++hits;
+            }
+        }
+        stats_.add(detail::Stat::Hit, hits);
+        stats_.add(detail::Stat::Miss, count - hits);
+        return hits;
+    }
+
+    // 批量写入的通用形式：第i个条目为(keyAt(i), valueAt(i))，整批只加一次锁
+    template<typename KeyAt, typename ValueAt>
+    void putBatch(size_t count, KeyAt&& keyAt, ValueAt&& valueAt)
+    {
+        if (budget_.capacity() == 0)
             return;
+
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        uint64_t expireAt = CoarseClock::expireAt(defaultTtl_);
+        for (size_t i = 0; i < count; ++i)
+        {
+            emplaceLocked(keyAt(i), expireAt, valueAt(i));
         }
+    }
 
-        putInternal(key, value);
+    // 查询key当前的有效访问频次，不计为一次访问 | key不存在或已过期返回false
+    bool frequency(const Key& key, long long& freq)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = nodeMap_.find(key);
+        if (it == nodeMap_.end() || expired(*it->second))
+            return false;
+        freq = effectiveFreq(it->second->bucket);
+        return true;
     }
 
-    // value值为传出参数
-    bool get(Key key, Value& value) override
+    // 条目数，先回收已到期的条目
+    size_t size()
     {
-      std::lock_guard<std::mutex> lock(mutex_);
-      auto it = nodeMap_.find(key);
-      if (it != nodeMap_.end())
-      {
-          getInternal(it->second, value);
-          return true;
-      }
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        return nodeMap_.size();
+    }
+
+    // 当前总权重：未设weigher时等于条目数
+    size_t weight()
+    {
+        auto lock = stats_.lock(mutex_);
+        return budget_.weight();
+    }
 
-      return false;
+    // Lazy老化只累加衰减量，同样计一次agingPasses
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
     }
 
-    Value get(Key key) override
+    // 与其他分片共享一个全局总权重(分片缓存使用)，需在写入任何数据之前调用
+    void shareWeight(std::atomic<size_t>* total)
     {
-      Value value;
-      get(key, value);
-      return value;
+        auto lock = stats_.lock(mutex_);
+        budget_.share(total);
     }
 
-      // 清空缓存,回收资源
+    // 清空缓存,回收资源(结点和频次桶归还对象池，供之后复用)
     void purge()
     {
-      nodeMap_.clear();
-      freqToFreqList_.clear();
+        auto lock = stats_.lock(mutex_);
+        while (freqHead_)
+        {
+            FreqBucket* bucket = freqHead_;
+            while (bucket->head)
+            {
+                Node* node = bucket->head;
+                bucket->head = node->next;
+                nodePool_.destroy(node);
+            }
+            freqHead_ = bucket->next;
+            bucketPool_.destroy(bucket);
+        }
+        nodeMap_.clear();
+        budget_.reset();
+        wheel_.reset();
+        curTotalNum_ = 0;
+        curAverageNum_ = 0;
+        decay_ = 0;
+        clampedTail_ = nullptr;
     }
 
 private:
-    void putInternal(Key key, Value value); // 添加缓存
-    void getInternal(NodePtr node, Value& value); // 获取缓存
+    static constexpr size_t kBatchChunk = 16;
 
-    void kickOut(); // 移除缓存中的过期数据
+    template<typename... Args>
+    void emplaceLocked(const Key& key, uint64_t expireAt, Args&&... args) // 存在则更新，否则添加
+    {
+        auto it = nodeMap_.find(key);
+        if (it != nodeMap_.end())
+        {
+            // 重置其value值，找到了直接调整就好了，不用再去get中再找一遍
+            updateInternal(it->second, expireAt, std::forward<Args>(args)...);
+            return;
+        }
+
+        putInternal(key, expireAt, std::forward<Args>(args)...);
+    }
 
-    void removeFromFreqList(NodePtr node); // 从频率列表中移除节点
-    void addToFreqList(NodePtr node); // 添加到频率列表
+    template<typename... Args>
+    void putInternal(const Key& key, uint64_t expireAt, Args&&... args); // 添加缓存
+    void getInternal(Node* node); // 命中缓存，更新访问频次
+    template<typename... Args>
+    void updateInternal(Node* node, uint64_t expireAt, Args&&... args); // 更新已存在结点的value
+
+    static bool expired(const Node& node) // 结点是否已过期(可能尚未回收)
+    {
+        return node.expireAt != 0 && node.expireAt <= CoarseClock::nowMs();
+    }
+    void expireLocked(); // 推进时间轮，回收已到期的结点
+    void setExpireAt(Node* node, uint64_t expireAt); // 记录过期时刻并挂到(或挪到、摘下)时间轮
+
+    bool kickOut(); // 移除缓存中的过期数据 | 没有可淘汰的结点时返回false
+    void removeInternal(Node* node); // 删除结点并扣除其权重
+
+    void linkNode(FreqBucket* bucket, Node* node); // 把结点加到频次桶的队尾
+    void unlinkNode(Node* node); // 把结点移出所在的频次桶，桶空了则回收
+    FreqBucket* insertBucketAfter(FreqBucket* pre, long long freq); // pre为空时插到最前面
+    void removeBucket(FreqBucket* bucket);
+    FreqBucket* firstUnclamped(); // 第一个有效频次大于1的桶，同时把clampedTail_推进到它之前
+
+    long long effectiveFreq(const FreqBucket* bucket) const // 桶的有效访问频次
+    {
+        return std::max(1LL, bucket->freq - decay_);
+    }
 
     void addFreqNum(); // 增加平均访问等频率
-    void decreaseFreqNum(int num); // 减少平均访问等频率
+    void decreaseFreqNum(long long num); // 减少平均访问等频率
     void handleOverMaxAverageNum(); // 处理当前平均访问频率超过上限的情况
-    void updateMinFreq();
 
 private:
-    int                                            capacity_; // 缓存容量
-    int                                            minFreq_; // 最小访问频次(用于找到最小访问频次结点)
-    int                                            maxAverageNum_; // 最大平均访问频次
-    int                                            curAverageNum_; // 当前平均访问频次
-    int                                            curTotalNum_; // 当前访问所有缓存次数总数 
-    std::mutex                                     mutex_; // 互斥锁
-    NodeMap                                        nodeMap_; // key 到 缓存节点的映射
-    std::unordered_map<int, FreqList<Key, Value>*> freqToFreqList_;// 访问频次到该频次链表的映射
+    detail::WeightBudget<Key, Value>   budget_; // 容量记账，默认按条目数
+    int                                maxAverageNum_; // 最大平均访问频次
+    int                                curAverageNum_; // 当前平均访问频次
+    long long                          curTotalNum_; // 当前访问所有缓存次数总数
+    LfuAging                           aging_; // 频次老化方式
+    long long                          decay_; // Lazy老化累计的衰减量，Eager时恒为0
+    std::mutex                         mutex_; // 互斥锁
+    detail::StatsCounter               stats_; // 运行统计
+    NodeMap                            nodeMap_; // key 到 缓存结点的映射
+    FreqBucket*                        freqHead_; // 频次最小的桶，淘汰从这里开始
+    FreqBucket*                        clampedTail_; // 已知有效频次为1的前缀中的最后一个桶，可为空(只是提示，可能落后)
+    detail::ObjectPool<Node>           nodePool_; // 结点对象池
+    detail::ObjectPool<FreqBucket>     bucketPool_; // 频次桶对象池，空桶回收后复用
+    std::chrono::milliseconds          defaultTtl_{0}; // 默认TTL，0表示永不过期
+    std::unique_ptr<TimerWheel<Node>>  wheel_; // 过期时间轮，第一次写入带TTL的条目时才创建
 };
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::getInternal(NodePtr node, Value& value)
+void LFUCache<Key, Value>::getInternal(Node* node)
 {
-    // 找到之后需要将其从低访问频次的链表中删除，并且添加到+1的访问频次链表中，
-    // 访问频次+1, 然后把value值返回
-    value = node->value;
-    // 从原有访问频次的链表中删除节点
-    removeFromFreqList(node); 
-    node->freq++;
-    addToFreqList(node);
-    // 如果当前node的访问频次如果等于minFreq+1，并且其前驱链表为空，则说明
-    // freqToFreqList_[node->freq - 1]链表因node的迁移已经空了，需要更新最小访问频次
-    if (node->freq - 1 == minFreq_ && freqToFreqList_[node->freq - 1]->isEmpty())
-        minFreq_++;
+    // 结点从当前频次桶挪到(有效频次+1)的桶，没有则在合适的位置新建一个
+    // 有效频次为1的桶(Lazy老化时可能有多个)里的结点统一挪到这段前缀之后，原始频次为(衰减量+2)的桶
+    FreqBucket* bucket = node->bucket;
+    FreqBucket* pre = bucket;
+    FreqBucket* next = bucket->next;
+    long long freq = bucket->freq + 1;
+    if (bucket->freq <= decay_ + 1)
+    {
+        freq = decay_ + 2;
+        next = firstUnclamped();
+        pre = clampedTail_;
+    }
+
+    if (pre == bucket && bucket->head == bucket->tail && (!next || next->freq != freq))
+    {
+        // 桶里只有这一个结点且它紧挨着目标位置，直接改桶的频次即可
+        if (clampedTail_ == bucket)
+            clampedTail_ = bucket->pre;
+        bucket->freq = freq;
+    }
+    else
+    {
+        if (!next || next->freq != freq)
+            next = insertBucketAfter(pre, freq);
+        unlinkNode(node);
+        linkNode(next, node);
+    }
 
     // 总访问频次和当前平均访问频次都随之增加
     addFreqNum();
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::putInternal(Key key, Value value)
-{   
-    // 如果不在缓存中，则需要判断缓存是否已满
-    if (nodeMap_.size() == capacity_)
-    {
-        // 缓存已满，删除最不常访问的结点，更新当前平均访问频次和总访问频次
-        kickOut();
-    }
-    
-    // 创建新结点，将新结点添加进入，更新最小访问频次
-    NodePtr node = std::make_shared<Node>(key, value);
-    nodeMap_[key] = node;
-    addToFreqList(node);
+template<typename... Args>
+void LFUCache<Key, Value>::putInternal(const Key& key, uint64_t expireAt, Args&&... args)
+{
+    // 先构造结点才能计算权重，单个条目超出整个预算时直接丢弃
+    Node* node = nodePool_.create(key, std::forward<Args>(args)...);
+    size_t charge = budget_.charge(key, node->value);
+    if (!budget_.fits(charge))
+    {
+        nodePool_.destroy(node);
+        return;
+    }
+
+    // 缓存已满，删除最不常访问的结点，直到放得下新结点(新结点尚未入桶，不会被淘汰)
+    stats_.add(detail::Stat::Insert);
+    budget_.add(charge);
+    while (budget_.overflow() && kickOut()) {}
+
+    // 将新结点添加进有效频次为1的前缀的最后一个桶(原始频次为衰减量+1)，排在更早的低频结点之后
+    nodeMap_.emplace(key, node);
+    setExpireAt(node, expireAt);
+    firstUnclamped();
+    FreqBucket* first = clampedTail_;
+    if (!first || first->freq != decay_ + 1)
+        first = insertBucketAfter(first, decay_ + 1);
+    linkNode(first, node);
     addFreqNum();
-    minFreq_ = std::min(minFreq_, 1);
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::kickOut()
+template<typename... Args>
+void LFUCache<Key, Value>::updateInternal(Node* node, uint64_t expireAt, Args&&... args)
 {
-    NodePtr node = freqToFreqList_[minFreq_]->getFirstNode();
-    removeFromFreqList(node);
-    nodeMap_.erase(node->key);
-    decreaseFreqNum(node->freq);
+    size_t oldCharge = budget_.charge(node->key, node->value);
+    detail::assignValue(node->value, std::forward<Args>(args)...);
+    setExpireAt(node, expireAt);
+    size_t newCharge = budget_.charge(node->key, node->value);
+    budget_.sub(oldCharge);
+    budget_.add(newCharge);
+    stats_.add(detail::Stat::Update);
+    getInternal(node);
+
+    // value变大可能超出预算，此时继续淘汰；更新后的value本身就超出整个预算时直接删除
+    if (!budget_.fits(newCharge))
+        removeInternal(node);
+    else
+        while (budget_.overflow() && nodeMap_.size() > 1 && kickOut()) {}
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::removeFromFreqList(NodePtr node)
+void LFUCache<Key, Value>::expireLocked()
 {
-    // 检查结点是否为空
-    if (!node) 
+    if (!wheel_ || wheel_->empty())
         return;
-    
-    auto freq = node->freq;
-    freqToFreqList_[freq]->removeNode(node);
+
+    wheel_->advance(CoarseClock::nowMs(), [this](Node* node) {
+        removeInternal(node);
+    });
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::addToFreqList(NodePtr node)
+void LFUCache<Key, Value>::setExpireAt(Node* node, uint64_t expireAt)
 {
-    // 检查结点是否为空
-    if (!node) 
+    node->expireAt = expireAt;
+    if (expireAt == 0)
+    {
+        if (wheel_)
+            wheel_->cancel(node);
         return;
+    }
+    if (!wheel_)
+        wheel_ = std::make_unique<TimerWheel<Node>>(CoarseClock::nowMs());
+    wheel_->schedule(node);
+}
+
+template<typename Key, typename Value>
+bool LFUCache<Key, Value>::kickOut()
+{
+    // 最小频次桶的队首就是要淘汰的结点，空桶会被立即回收，所以第一个桶一定非空
+    if (!freqHead_)
+        return false;
+    removeInternal(freqHead_->head);
+    stats_.add(detail::Stat::Eviction);
+    return true;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::removeInternal(Node* node)
+{
+    long long freq = effectiveFreq(node->bucket);
+    unlinkNode(node);
+    nodeMap_.erase(node->key);
+    decreaseFreqNum(freq);
+    budget_.sub(budget_.charge(node->key, node->value));
+    if (wheel_)
+        wheel_->cancel(node);
+    nodePool_.destroy(node);
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::linkNode(FreqBucket* bucket, Node* node)
+{
+    node->bucket = bucket;
+    node->pre = bucket->tail;
+    node->next = nullptr;
+    if (bucket->tail)
+        bucket->tail->next = node;
+    else
+        bucket->head = node;
+    bucket->tail = node;
+}
+
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::unlinkNode(Node* node)
+{
+    FreqBucket* bucket = node->bucket;
+    if (node->pre)
+        node->pre->next = node->next;
+    else
+        bucket->head = node->next;
+    if (node->next)
+        node->next->pre = node->pre;
+    else
+        bucket->tail = node->pre;
+    node->pre = node->next = nullptr;
+    node->bucket = nullptr;
+
+    if (!bucket->head)
+        removeBucket(bucket);
+}
+
+template<typename Key, typename Value>
+typename LFUCache<Key, Value>::FreqBucket*
+LFUCache<Key, Value>::insertBucketAfter(FreqBucket* pre, long long freq)
+{
+    FreqBucket* bucket = bucketPool_.create(freq);
+    bucket->pre = pre;
+    bucket->next = pre ? pre->next : freqHead_;
+    if (bucket->next)
+        bucket->next->pre = bucket;
+    if (pre)
+        pre->next = bucket;
+    else
+        freqHead_ = bucket;
+    return bucket;
+}
 
-    // 添加进入相应的频次链表前需要判断该频次链表是否存在
-    auto freq = node->freq;
-    if (freqToFreqList_.find(node->freq) == freqToFreqList_.end())
+template<typename Key, typename Value>
+void LFUCache<Key, Value>::removeBucket(FreqBucket* bucket)
+{
+    if (clampedTail_ == bucket)
+        clampedTail_ = bucket->pre;
+    if (bucket->pre)
+        bucket->pre->next = bucket->next;
+    else
+        freqHead_ = bucket->next;
+    if (bucket->next)
+        bucket->next->pre = bucket->pre;
+    bucketPool_.destroy(bucket);
+}
+
+template<typename Key, typename Value>
+typename LFUCache<Key, Value>::FreqBucket* LFUCache<Key, Value>::firstUnclamped()
+{
+    // 衰减量只增不减，已经越过的桶之后一直是有效频次1，每个桶最多被越过一次(均摊O(1))
+    FreqBucket* bucket = clampedTail_ ? clampedTail_->next : freqHead_;
+    while (bucket && bucket->freq <= decay_ + 1)
     {
-        // 不存在则创建
-        freqToFreqList_[node->freq] = new FreqList<Key, Value>(node->freq);
+        clampedTail_ = bucket;
+        bucket = bucket->next;
     }
-
-    freqToFreqList_[freq]->addNode(node);
+    return bucket;
 }
 
 template<typename Key, typename Value>
@@ -251,23 +612,23 @@ void LFUCache<Key, Value>::addFreqNum()
     if (nodeMap_.empty())
         curAverageNum_ = 0;
     else
-        curAverageNum_ = curTotalNum_ / nodeMap_.size();
+        curAverageNum_ = static_cast<int>(curTotalNum_ / static_cast<long long>(nodeMap_.size()));
 
     if (curAverageNum_ > maxAverageNum_)
     {
-       handleOverMaxAverageNum();
+        handleOverMaxAverageNum();
     }
 }
 
 template<typename Key, typename Value>
-void LFUCache<Key, Value>::decreaseFreqNum(int num)
+void LFUCache<Key, Value>::decreaseFreqNum(long long num)
 {
     // 减少平均访问频次和总访问频次
     curTotalNum_ -= num;
     if (nodeMap_.empty())
         curAverageNum_ = 0;
     else
-        curAverageNum_ = curTotalNum_ / nodeMap_.size();
+        curAverageNum_ = static_cast<int>(curTotalNum_ / static_cast<long long>(nodeMap_.size()));
 }
 
 template<typename Key, typename Value>
@@ -276,43 +637,48 @@ void LFUCache<Key, Value>::handleOverMaxAverageNum()
     if (nodeMap_.empty())
         return;
 
-    // 当前平均访问频次已经超过了最大平均访问频次，所有结点的访问频次- (maxAverageNum_ / 2)
-    for (auto it = nodeMap_.begin(); it != nodeMap_.end(); ++it)
+    // 当前平均访问频次已经超过了最大平均访问频次，所有结点的访问频次- (maxAverageNum_ / 2)，最小为1
+    // 频次桶按频次有序，减去同一个数后仍然有序，只需改桶的频次；
+    // 降到1的桶整体并入第一个桶(按原频次从小到大拼接)，只有这部分结点要改所属的桶
+    long long decay = std::max(1, maxAverageNum_ / 2);
+    stats_.add(detail::Stat::AgingPass);
+    if (aging_ == LfuAging::Lazy)
     {
-        // 检查结点是否为空
-        if (!it->second)
-            continue;
-
-        NodePtr node = it->second;
-
-        // 先从当前频率列表中移除
-        removeFromFreqList(node);
-
-        // 减少频率
-        node->freq -= maxAverageNum_ / 2;
-        if (node->freq < 1) node->freq = 1;
-
-        // 添加到新的频率列表
-        addToFreqList(node);
+        // 只累加衰减量，各桶的有效频次随之下降；总访问次数按每个结点都减去decay估算
+        decay_ += decay;
+        long long size = static_cast<long long>(nodeMap_.size());
+        curTotalNum_ = std::max(size, curTotalNum_ - decay * size);
+        curAverageNum_ = static_cast<int>(curTotalNum_ / size);
+        return;
     }
 
-    // 更新最小频率
-    updateMinFreq();
-}
-
-template<typename Key, typename Value>
-void LFUCache<Key, Value>::updateMinFreq() 
-{
-    minFreq_ = INT8_MAX;
-    for (const auto& pair : freqToFreqList_) 
+    FreqBucket* first = freqHead_;
+    FreqBucket* bucket = freqHead_;
+    while (bucket)
     {
-        if (pair.second && !pair.second->isEmpty()) 
+        FreqBucket* next = bucket->next;
+        long long freq = std::max(1LL, bucket->freq - decay);
+        long long count = 0;
+        for (Node* node = bucket->head; node; node = node->next)
+            ++count;
+        curTotalNum_ -= (bucket->freq - freq) * count;
+        bucket->freq = freq;
+
+        if (bucket != first && freq == 1)
         {
-            minFreq_ = std::min(minFreq_, pair.first);
+            for (Node* node = bucket->head; node; node = node->next)
+                node->bucket = first;
+            first->tail->next = bucket->head;
+            bucket->head->pre = first->tail;
+            first->tail = bucket->tail;
+            bucket->head = bucket->tail = nullptr;
+            removeBucket(bucket);
         }
+        bucket = next;
     }
-    if (minFreq_ == INT8_MAX) 
-        minFreq_ = 1;
+    clampedTail_ = nullptr;
+
+    curAverageNum_ = static_cast<int>(curTotalNum_ / static_cast<long long>(nodeMap_.size()));
 }
 
 // 并没有牺牲空间换时间，他是把原有缓存大小进行了分片。
@@ -320,36 +686,136 @@ template<typename Key, typename Value>
 class KHashLfuCache
 {
 public:
-    KHashLfuCache(size_t capacity, int sliceNum, int maxAverageNum = 10)
-        : sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
-        , capacity_(capacity)
+    using Slice = CacheLineAligned<LFUCache<Key, Value>>;
+
+    // sliceNum会向上取整到2的幂，以便用掩码选择分片
+    KHashLfuCache(size_t capacity, int sliceNum, int maxAverageNum = 10, LfuAging aging = LfuAging::Eager)
+        : capacity_(capacity)
+        , sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()))
+        , sliceMask_(sliceNum_ - 1)
+        , totalWeight_(0)
     {
         size_t sliceSize = std::ceil(capacity_ / static_cast<double>(sliceNum_)); // 每个lfu分片的容量
-        for (int i = 0; i < sliceNum_; ++i)
+        for (size_t i = 0; i < sliceNum_; ++i)
         {
-            lfuSliceCaches_.emplace_back(new LFUCache<Key, Value>(sliceSize, maxAverageNum));
+            lfuSliceCaches_.emplace_back(new Slice(sliceSize, maxAverageNum, aging));
         }
     }
 
-    void put(Key key, Value value)
+    // 按字节限制容量：maxWeight是所有分片共享的全局字节预算，做法同HashLruCaches
+    KHashLfuCache(size_t maxWeight, int sliceNum, Weigher<Key, Value> weigher, int maxAverageNum = 10,
+                  LfuAging aging = LfuAging::Eager)
+        : capacity_(maxWeight)
+        , sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency()))
+        , sliceMask_(sliceNum_ - 1)
+        , totalWeight_(0)
     {
+        for (size_t i = 0; i < sliceNum_; ++i)
+        {
+            lfuSliceCaches_.emplace_back(new Slice(maxWeight, weigher, maxAverageNum, aging));
+            lfuSliceCaches_.back()->value.shareWeight(&totalWeight_.value);
+        }
+    }
+
+    void put(const Key& key, const Value& value)
+    {
+        observe(key, false);
         // 根据key找出对应的lfu分片
-        size_t sliceIndex = Hash(key) % sliceNum_;
-        lfuSliceCaches_[sliceIndex]->put(key, value);
+        slice(key).put(key, value);
+    }
+
+    void put(const Key& key, Value&& value)
+    {
+        observe(key, false);
+        slice(key).put(key, std::move(value));
+    }
+
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
+    {
+        observe(key, false);
+        slice(key).putWithTtl(key, std::forward<V>(value), ttl);
     }
 
-    bool get(Key key, Value& value)
+    void setDefaultTtl(std::chrono::milliseconds ttl)
     {
+        for (auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            lfuSliceCache->value.setDefaultTtl(ttl);
+        }
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        observe(key, true);
         // 根据key找出对应的lfu分片
-        size_t sliceIndex = Hash(key) % sliceNum_;
-        return lfuSliceCaches_[sliceIndex]->get(key, value);
+        return slice(key).get(key, value);
     }
 
-    Value get(Key key)
+    Value get(const Key& key)
     {
-        Value value;
-        get(key, value);
-        return value;
+        observe(key, true);
+        return slice(key).get(key);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        observe(key, true);
+        return slice(key).visit(key, std::forward<Visitor>(visitor));
+    }
+
+    // 读取key，未命中时加载并写入所在分片，并发未命中按分片合并，做法同HashLruCaches::getOrLoad
+    template<typename Loader>
+    Value getOrLoad(const Key& key, Loader&& loader)
+    {
+        observe(key, true);
+        return slice(key).getOrLoad(key, std::forward<Loader>(loader));
+    }
+
+    // 批量读取：先按分片分组，每个分片只加一次锁 | 返回命中个数
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found)
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        observeAll(keys, keys.size(), true);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(keys.size(), sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        size_t hits = 0;
+        for (size_t s = 0; s < sliceNum_; ++s)
+        {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0)
+                continue;
+            hits += lfuSliceCaches_[s]->value.visitBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j, const Value& v) { values[group[j]] = v; found[group[j]] = true; });
+        }
+        return hits;
+    }
+
+    // 批量写入：先按分片分组，每个分片只加一次锁
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values)
+    {
+        size_t total = std::min(keys.size(), values.size());
+        observeAll(keys, total, false);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(total, sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        for (size_t s = 0; s < sliceNum_; ++s)
+        {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0)
+                continue;
+            lfuSliceCaches_[s]->value.putBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j) -> const Value& { return values[group[j]]; });
+        }
     }
 
     // 清除缓存
@@ -357,22 +823,111 @@ public:
     {
         for (auto& lfuSliceCache : lfuSliceCaches_)
         {
-            lfuSliceCache->purge();
+            lfuSliceCache->value.purge();
+        }
+    }
+
+    size_t sliceNum() const { return sliceNum_; }
+
+    // 所有分片的总权重：未设weigher时等于条目数
+    size_t weight()
+    {
+        size_t total = 0;
+        for (auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            total += lfuSliceCache->value.weight();
+        }
+        return total;
+    }
+
+    // key所在的分片下标：混合哈希后按掩码选择，整数key的步长模式也能均匀分散
+    size_t sliceIndex(const Key& key) const
+    {
+        return detail::sliceIndex(detail::hashKey(key), sliceMask_);
+    }
+
+    // 各分片当前的条目数
+    std::vector<size_t> sliceSizes()
+    {
+        std::vector<size_t> sizes;
+        for (auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            sizes.push_back(lfuSliceCache->value.size());
         }
+        return sizes;
     }
 
+    // 所有分片进行中的getOrLoad加载数
+    size_t loadsInFlight() const
+    {
+        size_t total = 0;
+        for (const auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            total += lfuSliceCache->value.loadsInFlight();
+        }
+        return total;
+    }
+
+    // 所有分片的运行统计之和
+    CacheStats stats()
+    {
+        CacheStats total;
+        for (auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            total += lfuSliceCache->value.stats();
+        }
+        return total;
+    }
+
+    // 各分片的运行统计
+    std::vector<CacheStats> sliceStats()
+    {
+        std::vector<CacheStats> stats;
+        for (auto& lfuSliceCache : lfuSliceCaches_)
+        {
+            stats.push_back(lfuSliceCache->value.stats());
+        }
+        return stats;
+    }
+
+    // 挂接未命中率曲线估计器，做法同HashLruCaches::attachMrc
+    void attachMrc(MrcEstimator* mrc)
+    {
+        mrc_.store(mrc, std::memory_order_release);
+    }
+
+    MrcEstimator* mrc() const { return mrc_.load(std::memory_order_acquire); }
+
 private:
-    // 将key计算成对应哈希值
-    size_t Hash(Key key)
+    LFUCache<Key, Value>& slice(const Key& key)
+    {
+        return lfuSliceCaches_[sliceIndex(key)]->value;
+    }
+
+    void observe(const Key& key, bool counted)
     {
-        std::hash<Key> hashFunc;
-        return hashFunc(key);
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire))
+            mrc->record(key, counted);
+    }
+
+    void observeAll(const std::vector<Key>& keys, size_t count, bool counted)
+    {
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire))
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                mrc->record(keys[i], counted);
+            }
+        }
     }
 
 private:
     size_t capacity_; // 缓存总容量
-    int sliceNum_; // 缓存分片数量
-    std::vector<std::unique_ptr<LFUCache<Key, Value>>> lfuSliceCaches_; // 缓存lfu分片容器
+    size_t sliceNum_; // 缓存分片数量(2的幂)
+    size_t sliceMask_;
+    CacheLineAligned<std::atomic<size_t>> totalWeight_; // 按字节限制时各分片共享的全局总权重
+    std::vector<std::unique_ptr<Slice>> lfuSliceCaches_; // 缓存lfu分片容器，分片按缓存行对齐
+    std::atomic<MrcEstimator*> mrc_{nullptr}; // 挂接的未命中率曲线估计器，可为空
 };
 
 } // namespace Cache
@@ -1,152 +1,868 @@
 #pragma once 
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <atomic>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 #include <cmath>
+#include <cstdint>
 #include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+#include "MissRatioCurve.h"
+#include "TimerWheel.h"
 
 namespace Cache
 {
 
 // LRU缓存实现
+// bufferedReads为true时开启"读缓冲"模式(Caffeine的做法)：
+// 命中只在分段的并发索引上加共享锁读取，访问记录写入按线程分条的有损读缓冲，
+// 由下一个拿到mutex_的线程批量回放到LRU链表，读线程之间不再为调整链表而串行
+// 传入weigher时容量按字节计算，每个条目计 weigher(key, value) + kEntryOverhead，淘汰直到总量不超出预算
+// 支持按条目和默认TTL：过期的条目立即按未命中处理，由时间轮在后续的写操作中回收
 
 template<typename Key, typename Value>
 class LRUCache : public CachePolicy<Key, Value>
 {
 public:
-    using Node = std::pair<Key, Value>;
+    struct Node : TimerLink
+    {
+        template<typename... Args>
+        explicit Node(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...) {}
+
+        Key      key;
+        Value    value;
+        uint64_t expireAt = 0; // 过期时刻(CoarseClock毫秒)，0表示永不过期，非0时节点挂在时间轮上
+    };
     using ListIterator = typename std::list<Node>::iterator;
 
-    LRUCache(int capacity)
-        : capacity_(capacity) {}
+    // 每个条目的固定开销估算：链表节点 + 索引节点
+    static constexpr size_t kEntryOverhead =
+        detail::listNodeBytes<Node>() + detail::hashNodeBytes<Key, ListIterator>();
+
+    template<typename Bool = bool, detail::EnableIfBool<Bool> = 0>
+    LRUCache(int capacity, Bool bufferedReads = false)
+        : LRUCache(static_cast<size_t>(capacity > 0 ? capacity : 0), nullptr, bufferedReads)
+    {}
+
+    // 按字节限制容量：maxWeight为字节预算
+    LRUCache(size_t maxWeight, Weigher<Key, Value> weigher, bool bufferedReads = false)
+        : budget_(maxWeight, std::move(weigher), kEntryOverhead)
+        , bufferedReads_(bufferedReads)
+        , indexStripes_(bufferedReads ? kIndexStripes : 1)
+        , readBuffers_(bufferedReads ? detail::nextPowerOfTwo(std::thread::hardware_concurrency()) : 0)
+    {}
 
     ~LRUCache() override = default;
 
-    void put(Key key, Value value) override
+    void put(const Key& key, const Value& value) override
     {
-        if (capacity_ <= 0) return;
+        emplace(key, value);
+    }
 
-        std::lock_guard<std::mutex> lock(mutex_);
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
 
-        auto it = cacheMap_.find(key);
-        if (it != cacheMap_.end()) {
-            // 存在则更新并移到前面
-            it->second->second = value;
-            cacheList_.splice(cacheList_.begin(), cacheList_, it->second);
-        } else {
-            // 不存在则新建
-            if (cacheList_.size() >= capacity_) {
-                // 删除最久未使用元素
-                auto del = cacheList_.back();
-                cacheMap_.erase(del.first);
-                cacheList_.pop_back();
-            }
-            cacheList_.emplace_front(key, value);
-            cacheMap_[key] = cacheList_.begin();
+    // 就地构造value，已存在则用参数重新赋值
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (budget_.capacity() == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        drainReadBuffers();
+        expireLocked();
+        emplaceLocked(key, CoarseClock::expireAt(defaultTtl_), std::forward<Args>(args)...);
+    }
+
+    // 写入并指定该条目的TTL，ttl不大于0表示永不过期
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
+    {
+        if (budget_.capacity() == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        drainReadBuffers();
+        expireLocked();
+        emplaceLocked(key, CoarseClock::expireAt(ttl), std::forward<V>(value));
+    }
+
+    // 之后写入的条目默认的TTL，不大于0表示永不过期(默认)
+    void setDefaultTtl(std::chrono::milliseconds ttl)
+    {
+        auto lock = stats_.lock(mutex_);
+        defaultTtl_ = ttl;
+    }
+
+    // 仅在key不存在时插入，已存在则什么都不做 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (budget_.capacity() == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        drainReadBuffers();
+        expireLocked();
+        IndexStripe& stripe = stripeOf(key);
+        auto it = stripe.map.find(key);
+        if (it != stripe.map.end()) {
+            if (!expired(*it->second)) return false;
+            eraseLocked(stripe, it); // 已过期但还没回收的条目视为不存在
         }
+        insertNew(key, CoarseClock::expireAt(defaultTtl_), std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
     }
 
-    bool get(Key key, Value& value) override
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = cacheMap_.find(key);
-        if (it == cacheMap_.end()) return false;
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中时在锁内以只读引用调用visitor，不拷贝value
+    // 读缓冲模式下visitor只在索引分段的共享锁内执行，多个读者可以同时访问
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        if (bufferedReads_) {
+            IndexStripe& stripe = stripeOf(key);
+            {
+                std::shared_lock<std::shared_mutex> stripeLock(stripe.mutex);
+                auto it = stripe.map.find(key);
+                if (it == stripe.map.end() || expired(*it->second)) {
+                    stats_.addConcurrent(detail::Stat::Miss);
+                    return false;
+                }
+                visitor(static_cast<const Value&>(it->second->value));
+            }
+            stats_.addConcurrent(detail::Stat::Hit);
+            recordRead(key);
+            return true;
+        }
+
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        IndexStripe& stripe = stripeOf(key);
+        auto it = stripe.map.find(key);
+        if (it == stripe.map.end()) {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+        if (expired(*it->second)) {
+            eraseLocked(stripe, it);
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+        stats_.add(detail::Stat::Hit);
 
         // 将节点移动到链表头部
         cacheList_.splice(cacheList_.begin(), cacheList_, it->second);
-        value = it->second->second;
+        visitor(static_cast<const Value&>(it->second->value));
         return true;
     }
 
-    Value get(Key key) override
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found) override
     {
-        Value value{};
-        get(key, value);
-        return value;
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        return visitBatch(keys.size(),
+                          [&keys](size_t i) -> const Key& { return keys[i]; },
+                          [&](size_t i, const Value& v) { values[i] = v; found[i] = true; });
+    }
+
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values) override
+    {
+        putBatch(std::min(keys.size(), values.size()),
+                 [&keys](size_t i) -> const Key& { return keys[i]; },
+                 [&values](size_t i) -> const Value& { return values[i]; });
+    }
+
+    // 批量访问的通用形式(分片缓存按分片分组后调用)：count个key由keyAt(i)给出，
+    // 整批只加一次锁，命中时调用visitor(i, value) | 返回命中个数
+    // 每kBatchChunk个key先集中做索引查找并预取链表节点，再统一调整链表，让各次cache miss重叠
+    // 读缓冲模式下同样在mutex_内直接调整链表，不经过读缓冲
+    template<typename KeyAt, typename Visitor>
+    size_t visitBatch(size_t count, KeyAt&& keyAt, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        size_t hits = 0;
+        std::array<ListIterator, kBatchChunk> nodes;
+        std::array<bool, kBatchChunk> hit;
+        for (size_t base = 0; base < count; base += kBatchChunk) {
+            size_t n = std::min(kBatchChunk, count - base);
+            for (size_t j = 0; j < n; ++j) {
+                IndexStripe& stripe = stripeOf(keyAt(base + j));
+                auto it = stripe.map.find(keyAt(base + j));
+                hit[j] = it != stripe.map.end();
+                if (hit[j]) {
+                    nodes[j] = it->second;
+                    detail::prefetch(&*nodes[j]);
+                }
+            }
+            for (size_t j = 0; j < n; ++j) {
+                // 过期的条目按未命中处理，留给时间轮回收，避免删除同一批中重复key仍引用的节点
+                if (!hit[j] || expired(*nodes[j])) continue;
+                cacheList_.splice(cacheList_.begin(), cacheList_, nodes[j]);
+                visitor(base + j, static_cast<const Value&>(nodes[j]->value));
+                ++hits;
+            }
+        }
+        stats_.add(detail::Stat::Hit, hits);
+        stats_.add(detail::Stat::Miss, count - hits);
+        return hits;
+    }
+
+    // 批量写入的通用形式：第i个条目为(keyAt(i), valueAt(i))，整批只加一次锁
+    template<typename KeyAt, typename ValueAt>
+    void putBatch(size_t count, KeyAt&& keyAt, ValueAt&& valueAt)
+    {
+        if (budget_.capacity() == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        drainReadBuffers();
+        expireLocked();
+        uint64_t expireAt = CoarseClock::expireAt(defaultTtl_);
+        for (size_t i = 0; i < count; ++i) {
+            emplaceLocked(keyAt(i), expireAt, valueAt(i));
+        }
+    }
+
+    // 条目数，先回收已到期的条目
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        expireLocked();
+        return cacheList_.size();
+    }
+
+    // 当前总权重：未设weigher时等于条目数
+    size_t weight()
+    {
+        auto lock = stats_.lock(mutex_);
+        return budget_.weight();
+    }
+
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+    // 与其他分片共享一个全局总权重(分片缓存使用)，需在写入任何数据之前调用
+    void shareWeight(std::atomic<size_t>* total)
+    {
+        auto lock = stats_.lock(mutex_);
+        budget_.share(total);
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        drainReadBuffers();
+        IndexStripe& stripe = stripeOf(key);
+        auto it = stripe.map.find(key);
+        if (it != stripe.map.end()) {
+            eraseLocked(stripe, it);
+        }
+    }
+
+private:
+    static constexpr size_t kIndexStripes = 16;
+    static constexpr size_t kReadBufferSize = 32;
+    static constexpr size_t kBatchChunk = 16;
+
+    // 并发索引的一个分段：写操作需持有mutex_和分段写锁，读缓冲模式下的读操作只持有分段读锁
+    struct alignas(64) IndexStripe
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<Key, ListIterator> map; // key -> list迭代器
+    };
+
+    // 按线程分条的读缓冲，记录命中的key，满了或拿不到锁时直接丢弃(有损)
+    struct alignas(64) ReadBuffer
+    {
+        std::mutex mutex;
+        size_t count = 0;
+        std::array<Key, kReadBufferSize> keys{};
+    };
+
+    using StripeWriteLock = std::unique_lock<std::shared_mutex>;
+
+    IndexStripe& stripeOf(const Key& key)
+    {
+        if (indexStripes_.size() == 1) return indexStripes_[0];
+        return indexStripes_[detail::hashKey(key) & (indexStripes_.size() - 1)];
+    }
+
+    // 普通模式下所有访问都在mutex_内，不需要分段锁
+    StripeWriteLock lockStripe(IndexStripe& stripe)
+    {
+        return bufferedReads_ ? StripeWriteLock(stripe.mutex) : StripeWriteLock();
+    }
+
+    void recordRead(const Key& key)
+    {
+        ReadBuffer& buffer = readBuffers_[detail::threadStripe() & (readBuffers_.size() - 1)];
+        bool full = false;
+        if (buffer.mutex.try_lock()) {
+            if (buffer.count < kReadBufferSize) {
+                buffer.keys[buffer.count++] = key;
+            }
+            full = buffer.count == kReadBufferSize;
+            buffer.mutex.unlock();
+        }
+
+        // 缓冲满了就尝试顺手回放，拿不到锁说明有线程正在写，交给它处理
+        if (full && mutex_.try_lock()) {
+            drainReadBuffers();
+            mutex_.unlock();
+        }
+    }
+
+    // 需持有mutex_：把读缓冲中记录的访问按顺序回放到LRU链表
+    void drainReadBuffers()
+    {
+        for (ReadBuffer& buffer : readBuffers_) {
+            std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+            for (size_t i = 0; i < buffer.count; ++i) {
+                IndexStripe& stripe = stripeOf(buffer.keys[i]);
+                auto it = stripe.map.find(buffer.keys[i]);
+                if (it != stripe.map.end()) {
+                    cacheList_.splice(cacheList_.begin(), cacheList_, it->second);
+                }
+            }
+            buffer.count = 0;
+        }
+    }
+
+    static bool expired(const Node& node)
+    {
+        return node.expireAt != 0 && node.expireAt <= CoarseClock::nowMs();
+    }
+
+    // 需持有mutex_：推进时间轮，回收已到期的条目
+    void expireLocked()
+    {
+        if (!wheel_ || wheel_->empty()) return;
+
+        wheel_->advance(CoarseClock::nowMs(), [this](Node* node) {
+            IndexStripe& stripe = stripeOf(node->key);
+            eraseLocked(stripe, stripe.map.find(node->key));
+        });
+    }
+
+    // 需持有mutex_：记录节点的过期时刻，需要过期的挂到(或挪到)时间轮上，不再过期的摘下
+    void setExpireAt(Node& node, uint64_t expireAt)
+    {
+        node.expireAt = expireAt;
+        if (expireAt == 0) {
+            if (wheel_) wheel_->cancel(&node);
+            return;
+        }
+        if (!wheel_) wheel_ = std::make_unique<TimerWheel<Node>>(CoarseClock::nowMs());
+        wheel_->schedule(&node);
+    }
+
+    // 需持有mutex_：存在则更新并移到前面，否则插入
+    template<typename... Args>
+    void emplaceLocked(const Key& key, uint64_t expireAt, Args&&... args)
+    {
+        IndexStripe& stripe = stripeOf(key);
+        auto it = stripe.map.find(key);
+        if (it != stripe.map.end()) {
+            ListIterator node = it->second;
+            size_t oldCharge = budget_.charge(node->key, node->value);
+            {
+                StripeWriteLock stripeLock = lockStripe(stripe);
+                detail::assignValue(node->value, std::forward<Args>(args)...);
+                setExpireAt(*node, expireAt);
+            }
+            size_t newCharge = budget_.charge(node->key, node->value);
+            budget_.sub(oldCharge);
+            budget_.add(newCharge);
+            stats_.add(detail::Stat::Update);
+            cacheList_.splice(cacheList_.begin(), cacheList_, node);
+            if (!budget_.fits(newCharge)) {
+                eraseLocked(stripe, it); // 更新后的value本身就超出预算
+                return;
+            }
+            evictOverflow();
+        } else {
+            insertNew(key, expireAt, std::forward<Args>(args)...);
+        }
+    }
+
+    // 需持有mutex_：从索引和链表中删除一个条目
+    void eraseLocked(IndexStripe& stripe, typename std::unordered_map<Key, ListIterator>::iterator it)
+    {
+        ListIterator node = it->second;
+        budget_.sub(budget_.charge(node->key, node->value));
+        {
+            StripeWriteLock stripeLock = lockStripe(stripe);
+            stripe.map.erase(it);
+        }
+        if (wheel_) wheel_->cancel(&*node);
+        cacheList_.erase(node);
     }
 
-    void remove(Key key)
+    // 需持有mutex_：从尾部淘汰最久未使用的条目，直到总权重不超出预算
+    // 先从索引摘除再释放链表节点，保证读者不会访问到已释放的节点
+    void evictOverflow()
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = cacheMap_.find(key);
-        if (it != cacheMap_.end()) {
-            cacheList_.erase(it->second);
-            cacheMap_.erase(it);
+        while (budget_.overflow() && cacheList_.size() > 1) {
+            IndexStripe& victimStripe = stripeOf(cacheList_.back().key);
+            eraseLocked(victimStripe, victimStripe.map.find(cacheList_.back().key));
+            stats_.add(detail::Stat::Eviction);
         }
     }
 
+    template<typename... Args>
+    void insertNew(const Key& key, uint64_t expireAt, Args&&... args)
+    {
+        // 先构造节点才能计算权重，单个条目超出整个预算时直接丢弃
+        cacheList_.emplace_front(key, std::forward<Args>(args)...);
+        size_t charge = budget_.charge(key, cacheList_.front().value);
+        if (!budget_.fits(charge)) {
+            cacheList_.pop_front();
+            return;
+        }
+        budget_.add(charge);
+        stats_.add(detail::Stat::Insert);
+        setExpireAt(cacheList_.front(), expireAt);
+        evictOverflow(); // 新节点在头部，淘汰从尾部开始，不会淘汰到它
+        IndexStripe& stripe = stripeOf(key);
+        StripeWriteLock stripeLock = lockStripe(stripe);
+        stripe.map.emplace(key, cacheList_.begin());
+    }
+
 private:
-    int capacity_;
+    detail::WeightBudget<Key, Value> budget_; // 容量记账，默认按条目数
+    bool bufferedReads_;
     std::list<Node> cacheList_; // 双向链表：头部是最近访问，尾部是最久未访问
-    std::unordered_map<Key, ListIterator> cacheMap_; // key -> list迭代器
+    std::vector<IndexStripe> indexStripes_; // 分段索引，普通模式下只有一段
+    std::vector<ReadBuffer> readBuffers_; // 读缓冲，仅读缓冲模式使用
+    std::chrono::milliseconds defaultTtl_{0}; // 默认TTL，0表示永不过期
+    std::unique_ptr<TimerWheel<Node>> wheel_; // 过期时间轮，第一次写入带TTL的条目时才创建
     std::mutex mutex_;
+    detail::StatsCounter stats_; // 运行统计，读缓冲模式下命中在mutex_之外计数
 };
 
 // LRU-k缓存
+// 历史队列与主缓存共用一个索引和一把锁，节点放在slab中用32位下标链接(同SlabLruCache)
+// 节点只记key、链接和最近k次访问的逻辑时间戳(32位，按与当前时钟的差还原)，不带value；
+// value放在单独的value槽slab里由节点按下标引用：主缓存每个条目一个，历史队列只有写入过的key才有，
+// 且历史中的value总数有上限，超出时丢掉最久未访问的历史value(节点保留，之后写入时再补上)
+// 累计访问满k次且有value时晋升到主缓存，主缓存内部按LRU淘汰
+// 只有写入过的key才建历史记录：cache-aside下未命中之后紧跟的put与这次未命中是同一次访问
 
 template<typename Key, typename Value>
-class KLruKCache : public LRUCache<Key, Value>
+class KLruKCache : public CachePolicy<Key, Value>
 {
 public:
-    KLruKCache(int capacity, int historyCapacity, int k)
-        : LRUCache<Key, Value>(capacity),
-          historyList_(std::make_unique<LRUCache<Key, size_t>>(historyCapacity)),
-          k_(k) {}
+    // historyValueCapacity: 历史队列中最多暂存多少个value，小于0时取主缓存容量
+    KLruKCache(int capacity, int historyCapacity, int k, int historyValueCapacity = -1)
+        : capacity_(capacity > 0 ? capacity : 0)
+        , historyCapacity_(historyCapacity > 0 ? historyCapacity : 0)
+        , historyValueCapacity_(historyValueCapacity >= 0 ? static_cast<size_t>(historyValueCapacity) : capacity_)
+        , k_(k > 0 ? std::min<uint32_t>(k, kMaxK) : 1)
+        , clock_(0)
+        , freeHead_(kNil)
+        , freeValueHead_(kNil)
+    {}
 
-    Value get(Key key)
+    ~KLruKCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    // 写入也算一次访问：在主缓存中则更新，否则暂存到历史节点，凑满k次访问时晋升
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        putLocked(key, std::forward<Args>(args)...);
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
     {
         Value value{};
-        bool inMain = LRUCache<Key, Value>::get(key, value);
-
-        size_t count = historyList_->get(key);
-        ++count;
-        historyList_->put(key, count);
-
-        if (inMain) return value;
-
-        if (count >= k_) {
-            auto it = historyValueMap_.find(key);
-            if (it != historyValueMap_.end()) {
-                Value storedValue = it->second;
-                historyList_->remove(key);
-                historyValueMap_.erase(it);
-                LRUCache<Key, Value>::put(key, storedValue);
-                return storedValue;
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中主缓存，或本次访问使历史节点凑满k次而晋升时，在锁内调用visitor
+    // 历史队列中的key未命中同样计入访问次数
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        if (capacity_ == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = accessLocked(key);
+        if (idx == kNil || !nodes_[idx].inMain) {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+        stats_.add(detail::Stat::Hit);
+        visitor(static_cast<const Value&>(values_[nodes_[idx].valueIdx].value));
+        return true;
+    }
+
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found) override
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        if (capacity_ == 0) return 0;
+
+        auto lock = stats_.lock(mutex_);
+        size_t hits = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uint32_t idx = accessLocked(keys[i]);
+            if (idx != kNil && nodes_[idx].inMain) {
+                values[i] = values_[nodes_[idx].valueIdx].value;
+                found[i] = true;
+                ++hits;
             }
         }
+        stats_.add(detail::Stat::Hit, hits);
+        stats_.add(detail::Stat::Miss, keys.size() - hits);
+        return hits;
+    }
 
-        return value;
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values) override
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        for (size_t i = 0; i < keys.size() && i < values.size(); ++i) {
+            putLocked(keys[i], values[i]);
+        }
     }
 
-    void put(Key key, Value value)
+    // key倒数第k次访问的逻辑时间戳(backward k-distance = 当前时钟 - 该值) | 访问不足k次或不存在返回false
+    bool kthAccessTime(const Key& key, uint64_t& stamp)
     {
-        Value existing;
-        if (LRUCache<Key, Value>::get(key, existing)) {
-            LRUCache<Key, Value>::put(key, value);
-            return;
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end() || nodes_[it->second].count < k_) return false;
+        uint32_t stored = stamps_[static_cast<size_t>(it->second) * k_ + nodes_[it->second].cursor];
+        stamp = clock_ - static_cast<uint32_t>(static_cast<uint32_t>(clock_) - stored);
+        return true;
+    }
+
+    // 删除key：无论在主缓存还是历史队列中，都从索引和链表摘除并归还slab节点和value槽
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+        uint32_t idx = it->second;
+        release(nodes_[idx].inMain ? main_ : history_, idx);
+    }
+
+    // 主缓存中的条目数
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        return main_.size;
+    }
+
+    // 历史队列中的条目数
+    size_t historySize()
+    {
+        auto lock = stats_.lock(mutex_);
+        return history_.size;
+    }
+
+    // 历史队列中暂存的value数
+    size_t historyValues()
+    {
+        auto lock = stats_.lock(mutex_);
+        return historyValues_.size;
+    }
+
+    // 访问到历史队列中的key计为ghostHits，晋升到主缓存计为inserts
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint32_t kMaxK = UINT16_MAX;
+
+    struct Node
+    {
+        Key      key{};
+        uint32_t prev = kNil;
+        uint32_t next = kNil;     // 所在链表的后继 / 空闲链表
+        uint32_t valueIdx = kNil; // value槽下标，没有value时为kNil
+        uint16_t count = 0;       // 访问次数，达到k后不再增长
+        uint16_t cursor = 0;      // 时间戳环的写入位置，访问满k次后指向最早的一次
+        bool     inMain = false;  // 在主缓存还是历史队列
+    };
+
+    // value槽：属于历史节点时挂在historyValues_链表上，按最近访问排序
+    struct ValueSlot
+    {
+        Value    value{};
+        uint32_t owner = kNil; // 所属节点
+        uint32_t prev = kNil;
+        uint32_t next = kNil;  // historyValues_的后继 / 空闲链表
+    };
+
+    struct List
+    {
+        uint32_t head = kNil; // 最近访问
+        uint32_t tail = kNil; // 最久未访问
+        size_t   size = 0;
+    };
+
+    // 需持有mutex_：记录一次读访问并调整位置 | 返回节点下标，key没有记录时返回kNil
+    uint32_t accessLocked(const Key& key)
+    {
+        auto it = index_.find(key);
+        if (it == index_.end()) return kNil;
+
+        uint32_t idx = it->second;
+        recordAccess(idx);
+        Node& node = nodes_[idx];
+        if (node.inMain) {
+            moveToFront(nodes_, main_, idx);
+            return idx;
+        }
+        stats_.add(detail::Stat::GhostHit);
+        if (node.count >= k_ && node.valueIdx != kNil) {
+            promote(idx);
+        } else {
+            moveToFront(nodes_, history_, idx);
+            if (node.valueIdx != kNil) moveToFront(values_, historyValues_, node.valueIdx);
         }
+        return idx;
+    }
 
-        size_t count = historyList_->get(key);
-        ++count;
-        historyList_->put(key, count);
+    template<typename... Args>
+    void putLocked(const Key& key, Args&&... args)
+    {
+        uint32_t idx;
+        auto it = index_.find(key);
+        bool existed = it != index_.end();
+        if (existed) {
+            idx = it->second;
+            if (!nodes_[idx].inMain) stats_.add(detail::Stat::GhostHit);
+        } else {
+            bool direct = k_ <= 1 || historyCapacity_ == 0;
+            if (direct && k_ > 1) return; // 没有历史队列就无法凑满k次
+            idx = allocate(key, direct);
+        }
 
-        historyValueMap_[key] = value;
+        recordAccess(idx);
+        Node& node = nodes_[idx];
+        if (node.inMain) {
+            stats_.add(existed ? detail::Stat::Update : detail::Stat::Insert);
+            moveToFront(nodes_, main_, idx);
+        } else if (node.count >= k_) {
+            promote(idx);
+        } else {
+            moveToFront(nodes_, history_, idx);
+            if (node.valueIdx == kNil) attachValue(idx);
+            if (node.valueIdx == kNil) return; // 历史不暂存value
+            moveToFront(values_, historyValues_, node.valueIdx);
+        }
+        if (node.valueIdx == kNil) attachValue(idx);
+        detail::assignValue(values_[node.valueIdx].value, std::forward<Args>(args)...);
+    }
 
-        if (count >= k_) {
-            historyList_->remove(key);
-            historyValueMap_.erase(key);
-            LRUCache<Key, Value>::put(key, value);
+    void recordAccess(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        stamps_[static_cast<size_t>(idx) * k_ + node.cursor] = static_cast<uint32_t>(++clock_);
+        node.cursor = static_cast<uint16_t>(node.cursor + 1u == k_ ? 0 : node.cursor + 1);
+        if (node.count < k_) ++node.count;
+    }
+
+    // 分配一个新节点放到主缓存或历史队列头部，所在队列满了先腾出位置
+    uint32_t allocate(const Key& key, bool inMain)
+    {
+        List& list = inMain ? main_ : history_;
+        if (list.size >= (inMain ? capacity_ : historyCapacity_)) {
+            if (inMain) stats_.add(detail::Stat::Eviction);
+            release(list, list.tail);
         }
+
+        // slab按需增长，上限为主缓存与历史队列容量之和，之后只复用空闲节点
+        uint32_t idx = freeHead_;
+        if (idx != kNil) {
+            freeHead_ = nodes_[idx].next;
+        } else {
+            idx = static_cast<uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+            stamps_.resize(stamps_.size() + k_, 0);
+        }
+        Node& node = nodes_[idx];
+        node.key = key;
+        node.count = 0;
+        node.cursor = 0;
+        node.inMain = inMain;
+        pushFront(nodes_, list, idx);
+        index_.emplace(key, idx);
+        return idx;
+    }
+
+    // 给节点分配value槽；历史中的value已满时先丢掉最久未访问的那个
+    // value slab的上限为主缓存容量与historyValueCapacity_之和
+    void attachValue(uint32_t idx)
+    {
+        bool inMain = nodes_[idx].inMain;
+        if (!inMain) {
+            if (historyValueCapacity_ == 0) return;
+            if (historyValues_.size >= historyValueCapacity_) detachValue(values_[historyValues_.tail].owner);
+        }
+
+        uint32_t slot = freeValueHead_;
+        if (slot != kNil) {
+            freeValueHead_ = values_[slot].next;
+        } else {
+            slot = static_cast<uint32_t>(values_.size());
+            values_.emplace_back();
+        }
+        values_[slot].owner = idx;
+        values_[slot].prev = values_[slot].next = kNil;
+        if (!inMain) pushFront(values_, historyValues_, slot);
+        nodes_[idx].valueIdx = slot;
+    }
+
+    // 释放节点的value槽，value持有的资源随之释放
+    void detachValue(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        uint32_t slot = node.valueIdx;
+        if (slot == kNil) return;
+        if (!node.inMain) unlink(values_, historyValues_, slot);
+        values_[slot].value = Value();
+        values_[slot].owner = kNil;
+        values_[slot].next = freeValueHead_;
+        freeValueHead_ = slot;
+        node.valueIdx = kNil;
+    }
+
+    // 历史节点晋升到主缓存：读访问时带着暂存的value，写入时随后填入新value
+    void promote(uint32_t idx)
+    {
+        unlink(nodes_, history_, idx);
+        if (nodes_[idx].valueIdx != kNil) unlink(values_, historyValues_, nodes_[idx].valueIdx);
+        nodes_[idx].inMain = true;
+        if (main_.size >= capacity_) {
+            stats_.add(detail::Stat::Eviction);
+            release(main_, main_.tail);
+        }
+        stats_.add(detail::Stat::Insert);
+        pushFront(nodes_, main_, idx);
+    }
+
+    // 删除节点：从索引和链表摘除，释放value槽后放回空闲链表
+    void release(List& list, uint32_t idx)
+    {
+        index_.erase(nodes_[idx].key);
+        unlink(nodes_, list, idx);
+        detachValue(idx);
+        nodes_[idx].next = freeHead_;
+        freeHead_ = idx;
+    }
+
+    // 节点和value槽的链表操作，元素都带prev/next下标
+    template<typename Item>
+    static void unlink(std::vector<Item>& items, List& list, uint32_t idx)
+    {
+        Item& item = items[idx];
+        if (item.prev != kNil) items[item.prev].next = item.next;
+        else list.head = item.next;
+        if (item.next != kNil) items[item.next].prev = item.prev;
+        else list.tail = item.prev;
+        item.prev = item.next = kNil;
+        --list.size;
+    }
+
+    template<typename Item>
+    static void pushFront(std::vector<Item>& items, List& list, uint32_t idx)
+    {
+        Item& item = items[idx];
+        item.prev = kNil;
+        item.next = list.head;
+        if (list.head != kNil) items[list.head].prev = idx;
+        list.head = idx;
+        if (list.tail == kNil) list.tail = idx;
+        ++list.size;
+    }
+
+    template<typename Item>
+    static void moveToFront(std::vector<Item>& items, List& list, uint32_t idx)
+    {
+        if (idx == list.head) return;
+        unlink(items, list, idx);
+        pushFront(items, list, idx);
     }
 
 private:
-    int k_;
-    std::unique_ptr<LRUCache<Key, size_t>> historyList_;
-    std::unordered_map<Key, Value> historyValueMap_;
+    size_t                            capacity_;             // 主缓存容量
+    size_t                            historyCapacity_;      // 历史队列容量
+    size_t                            historyValueCapacity_; // 历史队列中暂存value的上限
+    uint32_t                          k_;
+    uint64_t                          clock_;         // 逻辑时钟，每次访问加一
+    uint32_t                          freeHead_;      // 空闲节点链表
+    uint32_t                          freeValueHead_; // 空闲value槽链表
+    List                              main_;          // 主缓存LRU链表
+    List                              history_;       // 历史队列LRU链表
+    List                              historyValues_; // 历史节点持有的value槽，按最近访问排序
+    std::vector<Node>                 nodes_;         // 主缓存与历史队列共用的节点slab，按需增长
+    std::vector<uint32_t>             stamps_;        // 每个节点k个访问时间戳(时钟低32位)组成的环
+    std::vector<ValueSlot>            values_;        // value槽slab，按需增长
+    std::unordered_map<Key, uint32_t> index_;         // 主缓存与历史队列共用的索引
+    std::mutex                        mutex_;
+    detail::StatsCounter              stats_;
 };
 
 // 分片 LRU
@@ -155,45 +871,225 @@ template<typename Key, typename Value>
 class HashLruCaches
 {
 public:
-    HashLruCaches(size_t capacity, int sliceNum)
+    using Slice = CacheLineAligned<LRUCache<Key, Value>>;
+
+    // sliceNum会向上取整到2的幂，以便用掩码选择分片
+    // bufferedReads: 各分片是否开启读缓冲模式，见LRUCache
+    template<typename Bool = bool, detail::EnableIfBool<Bool> = 0>
+    HashLruCaches(size_t capacity, int sliceNum, Bool bufferedReads = false)
         : capacity_(capacity),
-          sliceNum_(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())
+          sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())),
+          sliceMask_(sliceNum_ - 1),
+          totalWeight_(0)
     {
         size_t sliceSize = std::ceil(capacity / static_cast<double>(sliceNum_));
-        for (int i = 0; i < sliceNum_; ++i) {
-            lruSliceCaches_.emplace_back(new LRUCache<Key, Value>(sliceSize));
+        for (size_t i = 0; i < sliceNum_; ++i) {
+            lruSliceCaches_.emplace_back(new Slice(sliceSize, bufferedReads));
         }
     }
 
-    void put(Key key, Value value)
+    // 按字节限制容量：maxWeight是所有分片共享的全局字节预算
+    // 各分片把权重变化累加到同一个全局计数上，写入时若全局超出预算，由当前分片淘汰自己的条目；
+    // 当前分片淘汰空了仍超出时暂时容忍，由其他分片在下一次写入时继续淘汰，超出量不超过每分片一个条目
+    HashLruCaches(size_t maxWeight, int sliceNum, Weigher<Key, Value> weigher, bool bufferedReads = false)
+        : capacity_(maxWeight),
+          sliceNum_(detail::nextPowerOfTwo(sliceNum > 0 ? sliceNum : std::thread::hardware_concurrency())),
+          sliceMask_(sliceNum_ - 1),
+          totalWeight_(0)
     {
-        size_t index = hash(key) % sliceNum_;
-        lruSliceCaches_[index]->put(key, value);
+        for (size_t i = 0; i < sliceNum_; ++i) {
+            lruSliceCaches_.emplace_back(new Slice(maxWeight, weigher, bufferedReads));
+            lruSliceCaches_.back()->value.shareWeight(&totalWeight_.value);
+        }
     }
 
-    bool get(Key key, Value& value)
+    void put(const Key& key, const Value& value)
     {
-        size_t index = hash(key) % sliceNum_;
-        return lruSliceCaches_[index]->get(key, value);
+        observe(key, false);
+        slice(key).put(key, value);
     }
 
-    Value get(Key key)
+    void put(const Key& key, Value&& value)
     {
-        Value value{};
-        get(key, value);
-        return value;
+        observe(key, false);
+        slice(key).put(key, std::move(value));
+    }
+
+    template<typename V>
+    void putWithTtl(const Key& key, V&& value, std::chrono::milliseconds ttl)
+    {
+        observe(key, false);
+        slice(key).putWithTtl(key, std::forward<V>(value), ttl);
+    }
+
+    void setDefaultTtl(std::chrono::milliseconds ttl)
+    {
+        for (auto& lruSliceCache : lruSliceCaches_) {
+            lruSliceCache->value.setDefaultTtl(ttl);
+        }
+    }
+
+    bool get(const Key& key, Value& value)
+    {
+        observe(key, true);
+        return slice(key).get(key, value);
+    }
+
+    Value get(const Key& key)
+    {
+        observe(key, true);
+        return slice(key).get(key);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        observe(key, true);
+        return slice(key).visit(key, std::forward<Visitor>(visitor));
+    }
+
+    // 读取key，未命中时调用loader(key)加载并写入所在分片，见CachePolicy::getOrLoad
+    // 同一个key的并发未命中由所在分片的登记表合并，不同分片的加载互不争锁
+    template<typename Loader>
+    Value getOrLoad(const Key& key, Loader&& loader)
+    {
+        observe(key, true);
+        return slice(key).getOrLoad(key, std::forward<Loader>(loader));
+    }
+
+    // 批量读取：先按分片分组，每个分片只加一次锁 | 返回命中个数
+    size_t getMany(const std::vector<Key>& keys, std::vector<Value>& values, std::vector<bool>& found)
+    {
+        values.resize(keys.size());
+        found.assign(keys.size(), false);
+        observeAll(keys, keys.size(), true);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(keys.size(), sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        size_t hits = 0;
+        for (size_t s = 0; s < sliceNum_; ++s) {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0) continue;
+            hits += lruSliceCaches_[s]->value.visitBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j, const Value& v) { values[group[j]] = v; found[group[j]] = true; });
+        }
+        return hits;
+    }
+
+    // 批量写入：先按分片分组，每个分片只加一次锁
+    void putMany(const std::vector<Key>& keys, const std::vector<Value>& values)
+    {
+        size_t total = std::min(keys.size(), values.size());
+        observeAll(keys, total, false);
+        std::vector<uint32_t> order, offsets;
+        detail::groupBySlice(total, sliceNum_,
+                             [&](size_t i) { return sliceIndex(keys[i]); }, order, offsets);
+
+        for (size_t s = 0; s < sliceNum_; ++s) {
+            const uint32_t* group = order.data() + offsets[s];
+            size_t count = offsets[s + 1] - offsets[s];
+            if (count == 0) continue;
+            lruSliceCaches_[s]->value.putBatch(count,
+                [&](size_t j) -> const Key& { return keys[group[j]]; },
+                [&](size_t j) -> const Value& { return values[group[j]]; });
+        }
+    }
+
+    size_t sliceNum() const { return sliceNum_; }
+
+    // 所有分片的总权重：未设weigher时等于条目数
+    size_t weight()
+    {
+        size_t total = 0;
+        for (auto& lruSliceCache : lruSliceCaches_) {
+            total += lruSliceCache->value.weight();
+        }
+        return total;
+    }
+
+    // key所在的分片下标
+    size_t sliceIndex(const Key& key) const
+    {
+        return detail::sliceIndex(detail::hashKey(key), sliceMask_);
     }
 
+    // 各分片当前的条目数，用于观察负载是否均衡
+    std::vector<size_t> sliceSizes()
+    {
+        std::vector<size_t> sizes;
+        for (auto& lruSliceCache : lruSliceCaches_) {
+            sizes.push_back(lruSliceCache->value.size());
+        }
+        return sizes;
+    }
+
+    // 所有分片进行中的getOrLoad加载数
+    size_t loadsInFlight() const
+    {
+        size_t total = 0;
+        for (const auto& lruSliceCache : lruSliceCaches_) {
+            total += lruSliceCache->value.loadsInFlight();
+        }
+        return total;
+    }
+
+    // 所有分片的运行统计之和
+    CacheStats stats()
+    {
+        CacheStats total;
+        for (auto& lruSliceCache : lruSliceCaches_) {
+            total += lruSliceCache->value.stats();
+        }
+        return total;
+    }
+
+    // 各分片的运行统计，用于观察热点分片和锁竞争
+    std::vector<CacheStats> sliceStats()
+    {
+        std::vector<CacheStats> stats;
+        for (auto& lruSliceCache : lruSliceCaches_) {
+            stats.push_back(lruSliceCache->value.stats());
+        }
+        return stats;
+    }
+
+    // 挂接未命中率曲线估计器：之后每次读计为一次访问，写只更新访问顺序；传nullptr解除挂接
+    // 估计器由调用方持有，解除挂接且不再有进行中的访问之后才能销毁
+    void attachMrc(MrcEstimator* mrc)
+    {
+        mrc_.store(mrc, std::memory_order_release);
+    }
+
+    MrcEstimator* mrc() const { return mrc_.load(std::memory_order_acquire); }
+
 private:
-    size_t hash(Key key)
+    LRUCache<Key, Value>& slice(const Key& key)
+    {
+        return lruSliceCaches_[sliceIndex(key)]->value;
+    }
+
+    void observe(const Key& key, bool counted)
     {
-        return std::hash<Key>{}(key);
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire)) mrc->record(key, counted);
+    }
+
+    void observeAll(const std::vector<Key>& keys, size_t count, bool counted)
+    {
+        if (MrcEstimator* mrc = mrc_.load(std::memory_order_acquire)) {
+            for (size_t i = 0; i < count; ++i) mrc->record(keys[i], counted);
+        }
     }
 
 private:
     size_t capacity_;
-    int sliceNum_;
-    std::vector<std::unique_ptr<LRUCache<Key, Value>>> lruSliceCaches_;
+    size_t sliceNum_;
+    size_t sliceMask_;
+    CacheLineAligned<std::atomic<size_t>> totalWeight_; // 按字节限制时各分片共享的全局总权重
+    std::vector<std::unique_ptr<Slice>> lruSliceCaches_; // 分片按缓存行对齐，避免相邻分片的锁伪共享
+    std::atomic<MrcEstimator*> mrc_{nullptr}; // 挂接的未命中率曲线估计器，可为空
 };
 
 } // namespace Cache
\ No newline at end of file
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// 命中率曲线上的一个点：容量为capacity(条目数)的LRU缓存预计的命中率
+struct MrcPoint
+{
+    size_t capacity;
+    double hitRatio;
+};
+
+// 未命中率曲线(MRC)的在线估计，用SHARDS(Waldspurger等, FAST'15)的空间采样加重用距离统计：
+// - 只跟踪哈希低24位小于阈值T的key，采样率R = T / 2^24；同一个key要么总被采样、要么从不被采样
+// - 对采样到的访问求重用距离(上次访问以来访问过的不同采样key数)，除以R即为全体key上的距离
+// - 固定内存：最多同时跟踪maxSamples个采样key，超出时把T降到已跟踪key中最大的采样值，丢弃采样值不小于它的key
+// - 距离直方图按基准容量的1%分桶，覆盖1%~400%；估计值按SHARDS_adj修正(期望与实际采样数之差计入最短距离)
+// 得到的是同容量LRU的命中率，其它策略以它为参照；容量按条目数计
+// 线程安全：未被采样的访问只读一个原子阈值并按线程分条计数，被采样的访问才加锁
+class MrcEstimator
+{
+public:
+    // baseCapacity: 当前缓存的容量(条目数)，曲线覆盖它的1%~400%
+    // maxSamples: 同时跟踪的采样key上限，决定内存占用(每个约80字节)，默认8192时估计误差通常在1%以内
+    explicit MrcEstimator(size_t baseCapacity, size_t maxSamples = 8192)
+        : baseCapacity_(std::max<size_t>(1, baseCapacity))
+        , maxSamples_(std::max<size_t>(16, maxSamples))
+        , threshold_(kModulus)
+        , now_(0)
+        , tree_(maxSamples_ * kTimeSlotsPerSample + 1, 0)
+        , histogram_(kBuckets + 1, 0.0)
+        , sampledWeight_(0)
+    {
+        lastAccess_.reserve(maxSamples_ + 1);
+        heap_.reserve(maxSamples_ + 1);
+    }
+
+    MrcEstimator(const MrcEstimator&) = delete;
+    MrcEstimator& operator=(const MrcEstimator&) = delete;
+
+    // 记录一次访问：counted为false时只更新访问顺序，不计入命中率(如未命中后的回填写入)
+    template<typename Key>
+    void record(const Key& key, bool counted = true)
+    {
+        recordHash(detail::hashKey(key), counted);
+    }
+
+    void recordHash(uint64_t hash, bool counted = true)
+    {
+        if (counted)
+        {
+            references_[detail::threadStripe() & (kStripes - 1)].value.fetch_add(1, std::memory_order_relaxed);
+        }
+        uint32_t sample = static_cast<uint32_t>(hash) & (kModulus - 1);
+        if (sample >= threshold_.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sample >= threshold_.load(std::memory_order_relaxed))
+            return;
+        access(hash, sample, counted);
+    }
+
+    // 容量为capacity(条目数)时预计的命中率，超出400%时按400%计
+    double hitRatioAt(size_t capacity) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double total = static_cast<double>(references());
+        if (total <= 0) return 0.0;
+        double hits = adjustment(total) + cumulativeHits(static_cast<double>(capacity) * 100.0 / baseCapacity_);
+        return std::min(1.0, std::max(0.0, hits / total));
+    }
+
+    // 基准容量的1%~400%，每1%一个点
+    std::vector<MrcPoint> curve() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<MrcPoint> points;
+        points.reserve(kBuckets);
+        double total = static_cast<double>(references());
+        double hits = total > 0 ? adjustment(total) : 0.0;
+        for (size_t percent = 1; percent <= kBuckets; ++percent)
+        {
+            hits += histogram_[percent - 1];
+            double ratio = total > 0 ? std::min(1.0, std::max(0.0, hits / total)) : 0.0;
+            points.push_back(MrcPoint{std::max<size_t>(1, baseCapacity_ * percent / 100), ratio});
+        }
+        return points;
+    }
+
+    size_t baseCapacity() const { return baseCapacity_; }
+
+    // 当前的采样率
+    double samplingRate() const
+    {
+        return static_cast<double>(threshold_.load(std::memory_order_relaxed)) / kModulus;
+    }
+
+    // 计入命中率的访问总数
+    uint64_t references() const
+    {
+        uint64_t total = 0;
+        for (const auto& stripe : references_)
+        {
+            total += stripe.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // 估计器占用的字节数(跟踪表按满额计)
+    size_t memoryBytes() const
+    {
+        return sizeof(*this)
+            + maxSamples_ * (sizeof(std::pair<const uint64_t, uint32_t>) + 2 * sizeof(void*)) // 跟踪表的结点
+            + lastAccess_.bucket_count() * sizeof(void*)
+            + heap_.capacity() * sizeof(HeapEntry)
+            + tree_.capacity() * sizeof(int32_t)
+            + histogram_.capacity() * sizeof(double);
+    }
+
+private:
+    static constexpr uint32_t kModulus = 1u << 24;         // 采样值取哈希的低24位(分片下标用的是高32位)
+    static constexpr size_t   kBuckets = 400;              // 1%~400%
+    static constexpr size_t   kTimeSlotsPerSample = 4;     // 时间戳用满后压缩重排
+    static constexpr size_t   kStripes = 8;
+
+    using HeapEntry = std::pair<uint32_t, uint64_t>;       // (采样值, 指纹)，按采样值的大顶堆
+
+    void access(uint64_t hash, uint32_t sample, bool counted)
+    {
+        double rate = static_cast<double>(threshold_.load(std::memory_order_relaxed)) / kModulus;
+        double weight = counted ? 1.0 / rate : 0.0;
+        if (now_ + 1 >= tree_.size())
+            compact();
+
+        auto it = lastAccess_.find(hash);
+        if (it == lastAccess_.end())
+        {
+            // 首次访问：冷未命中，只计入采样总数
+            sampledWeight_ += weight;
+            lastAccess_.emplace(hash, now_);
+            heap_.emplace_back(sample, hash);
+            std::push_heap(heap_.begin(), heap_.end());
+            add(now_, 1);
+            ++now_;
+            if (lastAccess_.size() > maxSamples_)
+                lowerThreshold();
+            return;
+        }
+
+        // 重用距离 = (上次访问, 现在)之间仍标记着的时间戳个数 = 期间访问过的不同采样key数
+        uint32_t last = it->second;
+        int64_t distance = prefix(now_) - prefix(last + 1);
+        if (counted)
+        {
+            double scaled = static_cast<double>(distance) / rate;
+            size_t bucket = static_cast<size_t>(scaled * 100.0 / baseCapacity_);
+            histogram_[std::min(bucket, kBuckets)] += weight;
+            sampledWeight_ += weight;
+        }
+        add(last, -1);
+        add(now_, 1);
+        it->second = now_;
+        ++now_;
+    }
+
+    // 丢弃采样值最大的key(可能有多个相同值)，把阈值降到该值
+    void lowerThreshold()
+    {
+        uint32_t newThreshold = heap_.front().first;
+        while (!heap_.empty() && heap_.front().first >= newThreshold)
+        {
+            std::pop_heap(heap_.begin(), heap_.end());
+            auto it = lastAccess_.find(heap_.back().second);
+            add(it->second, -1);
+            lastAccess_.erase(it);
+            heap_.pop_back();
+        }
+        threshold_.store(newThreshold, std::memory_order_relaxed);
+    }
+
+    // 时间戳用满时，按原有先后把仍在跟踪的key重新编号为0..n-1并重建树状数组
+    void compact()
+    {
+        std::vector<std::pair<uint32_t, uint64_t>> order;
+        order.reserve(lastAccess_.size());
+        for (const auto& entry : lastAccess_)
+        {
+            order.emplace_back(entry.second, entry.first);
+        }
+        std::sort(order.begin(), order.end());
+        std::fill(tree_.begin(), tree_.end(), 0);
+        for (uint32_t i = 0; i < order.size(); ++i)
+        {
+            lastAccess_[order[i].second] = i;
+            add(i, 1);
+        }
+        now_ = static_cast<uint32_t>(order.size());
+    }
+
+    // 树状数组(Fenwick)：下标pos处加delta；prefix(n)为[0, n)之和
+    void add(uint32_t pos, int32_t delta)
+    {
+        for (size_t i = pos + 1; i < tree_.size(); i += i & (~i + 1))
+        {
+            tree_[i] += delta;
+        }
+    }
+
+    int64_t prefix(uint32_t n) const
+    {
+        int64_t sum = 0;
+        for (size_t i = n; i > 0; i -= i & (~i + 1))
+        {
+            sum += tree_[i];
+        }
+        return sum;
+    }
+
+    // 距离小于percent%基准容量的加权访问数，桶内线性插值
+    double cumulativeHits(double percent) const
+    {
+        percent = std::min(percent, static_cast<double>(kBuckets));
+        double hits = 0;
+        size_t whole = static_cast<size_t>(percent);
+        for (size_t b = 0; b < whole; ++b)
+        {
+            hits += histogram_[b];
+        }
+        if (whole < kBuckets)
+            hits += histogram_[whole] * (percent - whole);
+        return hits;
+    }
+
+    // SHARDS_adj：采样到的加权访问数与实际访问数之差，计入最短距离
+    double adjustment(double total) const
+    {
+        return total - sampledWeight_;
+    }
+
+private:
+    const size_t                  baseCapacity_;
+    const size_t                  maxSamples_;
+    std::array<CacheLineAligned<std::atomic<uint64_t>>, kStripes> references_;   // 计入命中率的访问数，按线程分条
+    std::atomic<uint32_t>         threshold_;    // 采样阈值T
+    mutable std::mutex            mutex_;        // 保护以下采样状态
+    uint32_t                      now_;          // 下一个时间戳
+    std::unordered_map<uint64_t, uint32_t> lastAccess_; // 指纹 -> 上次访问的时间戳
+    std::vector<HeapEntry>        heap_;         // 跟踪中的key，按采样值的大顶堆
+    std::vector<int32_t>          tree_;         // 各时间戳是否为某个key的最近一次访问
+    std::vector<double>           histogram_;    // 按基准容量1%分桶的加权重用次数，最后一桶为超出400%
+    double                        sampledWeight_; // 计入命中率的加权采样访问数
+};
+
+} // namespace Cache
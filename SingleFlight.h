@@ -0,0 +1,90 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace Cache
+{
+
+// 按key合并并发的加载(single-flight)：同一个key同时只有一次加载在进行，
+// 其余调用者等待并共享这次加载的结果；加载抛出的异常同样交给所有等待者，且不会被记住，下次调用重新加载
+// 加载在锁外执行，锁只保护进行中加载的登记表；每个缓存实例(分片缓存是每个分片)各有一张表，
+// 由CachePolicy::getOrLoad在第一次调用时创建
+// 注意：加载函数内不能再对同一个key调用run，否则会等待自己而死锁
+template<typename Key, typename Value>
+class SingleFlight
+{
+public:
+    SingleFlight() = default;
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    // key没有进行中的加载时由当前线程执行load()，否则等待那次加载 | 返回加载的结果或重新抛出它的异常
+    template<typename Load>
+    Value run(const Key& key, Load&& load)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = calls_.find(key);
+        if (it != calls_.end())
+        {
+            std::shared_ptr<Call> call = it->second;
+            call->ready.wait(lock, [&call]() { return call->done; });
+            if (call->error) std::rethrow_exception(call->error);
+            return call->value;
+        }
+        std::shared_ptr<Call> call = std::make_shared<Call>();
+        calls_.emplace(key, call);
+        lock.unlock();
+
+        try
+        {
+            Value value = load();
+            lock.lock();
+            call->value = value;
+            finish(call, key);
+            return value;
+        }
+        catch (...)
+        {
+            if (!lock.owns_lock()) lock.lock();
+            call->error = std::current_exception();
+            finish(call, key);
+            throw;
+        }
+    }
+
+    // 当前进行中的加载数
+    size_t inFlight() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return calls_.size();
+    }
+
+private:
+    // 一次进行中的加载，等待者持有它的shared_ptr，登记表摘除后仍能读到结果
+    struct Call
+    {
+        std::condition_variable ready;
+        bool                    done = false;
+        Value                   value{};
+        std::exception_ptr      error;
+    };
+
+    // 调用方持有mutex_：公布结果并摘除登记，之后再未命中的调用者会重新加载
+    void finish(const std::shared_ptr<Call>& call, const Key& key)
+    {
+        call->done = true;
+        calls_.erase(key);
+        call->ready.notify_all();
+    }
+
+private:
+    mutable std::mutex                                 mutex_;
+    std::unordered_map<Key, std::shared_ptr<Call>>     calls_; // 进行中的加载
+};
+
+} // namespace Cache
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// 基于slab的侵入式LRU缓存
+// 所有节点在构造时一次性分配(容量个)，节点之间用32位下标链接，
+// 哈希桶的头指针也直接放在节点数组里，稳态下put/get不再有任何堆分配
+template<typename Key, typename Value>
+class SlabLruCache : public CachePolicy<Key, Value>
+{
+public:
+    explicit SlabLruCache(int capacity)
+        : capacity_(capacity > 0 ? static_cast<uint32_t>(capacity) : 0)
+        , size_(0)
+        , head_(kNil)
+        , tail_(kNil)
+        , freeHead_(kNil)
+        , nodes_(capacity_)
+    {
+        // 空闲链表穿在next上
+        for (uint32_t i = 0; i < capacity_; ++i)
+        {
+            nodes_[i].next = (i + 1 < capacity_) ? i + 1 : kNil;
+        }
+        freeHead_ = capacity_ > 0 ? 0 : kNil;
+    }
+
+    ~SlabLruCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    // 就地给节点的value赋值，已存在则更新
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        uint32_t idx = findInBucket(key, bucket);
+        if (idx != kNil)
+        {
+            // 存在则更新并移到前面
+            stats_.add(detail::Stat::Update);
+            detail::assignValue(nodes_[idx].value, std::forward<Args>(args)...);
+            moveToFront(idx);
+            return;
+        }
+        insertNew(key, bucket, std::forward<Args>(args)...);
+    }
+
+    // 仅在key不存在时插入 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        if (findInBucket(key, bucket) != kNil) return false;
+        insertNew(key, bucket, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = findInBucket(key, bucketOf(key));
+        if (idx == kNil)
+        {
+            stats_.add(detail::Stat::Miss);
+            return Value{};
+        }
+
+        stats_.add(detail::Stat::Hit);
+        moveToFront(idx);
+        return nodes_[idx].value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t idx = findInBucket(key, bucketOf(key));
+        if (idx == kNil)
+        {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+
+        stats_.add(detail::Stat::Hit);
+        moveToFront(idx);
+        visitor(static_cast<const Value&>(nodes_[idx].value));
+        return true;
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        uint32_t bucket = bucketOf(key);
+        uint32_t idx = findInBucket(key, bucket);
+        if (idx == kNil) return;
+
+        unlinkFromBucket(idx, bucket);
+        unlinkFromList(idx);
+        nodes_[idx].value = Value(); // 释放value持有的资源
+        nodes_[idx].next = freeHead_;
+        freeHead_ = idx;
+        --size_;
+    }
+
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        return size_;
+    }
+
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Node
+    {
+        Key      key{};
+        Value    value{};
+        uint32_t prev = kNil;       // LRU链表前驱
+        uint32_t next = kNil;       // LRU链表后继 / 空闲链表
+        uint32_t hashNext = kNil;   // 同一哈希桶中的下一个节点
+        uint32_t bucketHead = kNil; // 以本下标为桶号的哈希桶的头节点
+    };
+
+    template<typename... Args>
+    void insertNew(const Key& key, uint32_t bucket, Args&&... args)
+    {
+        uint32_t idx;
+        if (freeHead_ == kNil)
+        {
+            // 满了则复用最久未使用的节点
+            stats_.add(detail::Stat::Eviction);
+            idx = tail_;
+            unlinkFromBucket(idx, bucketOf(nodes_[idx].key));
+            unlinkFromList(idx);
+        }
+        else
+        {
+            idx = freeHead_;
+            freeHead_ = nodes_[idx].next;
+            ++size_;
+        }
+
+        stats_.add(detail::Stat::Insert);
+        Node& node = nodes_[idx];
+        node.key = key;
+        detail::assignValue(node.value, std::forward<Args>(args)...);
+        node.hashNext = nodes_[bucket].bucketHead;
+        nodes_[bucket].bucketHead = idx;
+        pushFront(idx);
+    }
+
+    uint32_t bucketOf(const Key& key) const
+    {
+        return detail::fastRange(detail::hashKey(key), capacity_);
+    }
+
+    uint32_t findInBucket(const Key& key, uint32_t bucket) const
+    {
+        uint32_t idx = nodes_[bucket].bucketHead;
+        while (idx != kNil && !(nodes_[idx].key == key))
+        {
+            idx = nodes_[idx].hashNext;
+        }
+        return idx;
+    }
+
+    void unlinkFromBucket(uint32_t idx, uint32_t bucket)
+    {
+        uint32_t* link = &nodes_[bucket].bucketHead;
+        while (*link != idx)
+        {
+            link = &nodes_[*link].hashNext;
+        }
+        *link = nodes_[idx].hashNext;
+        nodes_[idx].hashNext = kNil;
+    }
+
+    void unlinkFromList(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        if (node.prev != kNil) nodes_[node.prev].next = node.next;
+        else head_ = node.next;
+        if (node.next != kNil) nodes_[node.next].prev = node.prev;
+        else tail_ = node.prev;
+        node.prev = node.next = kNil;
+    }
+
+    void pushFront(uint32_t idx)
+    {
+        Node& node = nodes_[idx];
+        node.prev = kNil;
+        node.next = head_;
+        if (head_ != kNil) nodes_[head_].prev = idx;
+        head_ = idx;
+        if (tail_ == kNil) tail_ = idx;
+    }
+
+    void moveToFront(uint32_t idx)
+    {
+        if (idx == head_) return;
+        unlinkFromList(idx);
+        pushFront(idx);
+    }
+
+private:
+    uint32_t          capacity_;
+    uint32_t          size_;
+    uint32_t          head_;     // 最近访问
+    uint32_t          tail_;     // 最久未访问
+    uint32_t          freeHead_; // 空闲节点链表
+    std::vector<Node> nodes_;    // 节点slab，同时承载哈希桶头
+    std::mutex        mutex_;
+    detail::StatsCounter stats_;
+};
+
+} // namespace Cache
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+// 粗粒度时钟：后台线程每毫秒把steady_clock的当前时间写进一个原子变量，
+// 读取只是一次relaxed load，get命中时判断过期不必每次调用steady_clock::now()
+class CoarseClock
+{
+public:
+    // 当前时间(毫秒)，精度约1ms
+    static uint64_t nowMs()
+    {
+        return instance().now_.load(std::memory_order_relaxed);
+    }
+
+    // 把毫秒时长换算为过期时刻 | ttl不大于0表示永不过期，返回0
+    static uint64_t expireAt(std::chrono::milliseconds ttl)
+    {
+        return ttl.count() > 0 ? nowMs() + static_cast<uint64_t>(ttl.count()) : 0;
+    }
+
+    ~CoarseClock()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        ticker_.join();
+    }
+
+private:
+    CoarseClock()
+        : now_(readSteady())
+        , stop_(false)
+        , ticker_([this]() { run(); })
+    {}
+
+    static CoarseClock& instance()
+    {
+        static CoarseClock clock;
+        return clock;
+    }
+
+    static uint64_t readSteady()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, std::chrono::milliseconds(1), [this]() { return stop_; }))
+        {
+            now_.store(readSteady(), std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t>   now_;
+    bool                    stop_;
+    std::mutex              mutex_;
+    std::condition_variable cv_;
+    std::thread             ticker_;
+};
+
+// 时间轮在缓存节点里的链接：节点继承它，同一时刻至多挂在时间轮的一个槽里
+// 拷贝出来的节点不在任何槽里
+struct TimerLink
+{
+    TimerLink() = default;
+    TimerLink(const TimerLink&) {}
+    TimerLink& operator=(const TimerLink&) { return *this; }
+
+    bool scheduled() const { return timerNext != nullptr; }
+
+    TimerLink* timerPrev = nullptr;
+    TimerLink* timerNext = nullptr;
+};
+
+// 分层时间轮：4层、每层64个槽，第0层每槽1ms，上一层每槽覆盖下一层一整圈，
+// 共覆盖约4.6小时，更远的节点放在溢出链表里，等最高层转完一圈再重新放置
+// 侵入式：Node继承TimerLink并带有expireAt成员，每个槽是节点组成的双向循环链表，
+// 每个节点至多挂一次，更新TTL时原地挪到新槽，删除时摘下，记录数不超过带TTL的存活条目数
+// 摘下节点不清除槽的占用位，推进时遇到空槽再清除；每个节点最多下放(cascade)层数次，
+// 登记、撤销、到期均摊O(1)；非线程安全，由所属缓存的锁保护，节点释放前必须先cancel
+template<typename Node>
+class TimerWheel
+{
+public:
+    explicit TimerWheel(uint64_t nowMs)
+        : current_(nowMs)
+        , count_(0)
+    {
+        occupied_.fill(0);
+        for (auto& level : slots_)
+        {
+            for (TimerLink& slot : level) clear(slot);
+        }
+        clear(overflow_);
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // 按node->expireAt登记节点，已经登记过的先摘下再放到新位置；已经过期的在下一次推进时到期
+    void schedule(Node* node)
+    {
+        if (node->scheduled())
+            unlink(node);
+        else
+            ++count_;
+        place(node, current_ + 1);
+    }
+
+    // 撤销节点的登记，未登记时什么也不做
+    void cancel(Node* node)
+    {
+        if (!node->scheduled()) return;
+        unlink(node);
+        --count_;
+    }
+
+    // 把时间轮推进到nowMs，对每个到期的节点先撤销登记再调用expire(node)
+    // 空槽按位图整段跳过，长时间空闲后的推进也不必逐毫秒检查
+    template<typename Expire>
+    void advance(uint64_t nowMs, Expire&& expire)
+    {
+        while (current_ < nowMs)
+        {
+            if (count_ == 0)
+            {
+                current_ = nowMs;
+                return;
+            }
+
+            uint64_t tick = current_ + 1;
+            if ((tick & kMask) != 0)
+            {
+                // 块内没有到边界：直接跳到本块内下一个非空的第0层槽，没有则跳到下一块的起点
+                uint64_t pending = occupied_[0] >> (tick & kMask);
+                tick = pending ? tick + detail::lowestBit(pending) : (tick | kMask) + 1;
+                if (tick > nowMs)
+                {
+                    current_ = nowMs;
+                    return;
+                }
+            }
+
+            current_ = tick;
+            cascade(tick);
+            fire(tick & kMask, expire);
+        }
+    }
+
+    bool empty() const { return count_ == 0; }
+    size_t size() const { return count_; }
+
+private:
+    static constexpr int      kLevels = 4;
+    static constexpr int      kBits = 6;
+    static constexpr uint64_t kSlots = 1ULL << kBits;
+    static constexpr uint64_t kMask = kSlots - 1;
+
+    static void clear(TimerLink& list)
+    {
+        list.timerPrev = &list;
+        list.timerNext = &list;
+    }
+
+    static bool isEmpty(const TimerLink& list)
+    {
+        return list.timerNext == &list;
+    }
+
+    static void append(TimerLink& list, TimerLink* link)
+    {
+        link->timerPrev = list.timerPrev;
+        link->timerNext = &list;
+        list.timerPrev->timerNext = link;
+        list.timerPrev = link;
+    }
+
+    static void unlink(TimerLink* link)
+    {
+        link->timerPrev->timerNext = link->timerNext;
+        link->timerNext->timerPrev = link->timerPrev;
+        link->timerPrev = nullptr;
+        link->timerNext = nullptr;
+    }
+
+    // 把list上的节点整体移到空链表out上，list清空
+    static void takeAll(TimerLink& list, TimerLink& out)
+    {
+        clear(out);
+        if (isEmpty(list)) return;
+        out.timerNext = list.timerNext;
+        out.timerPrev = list.timerPrev;
+        out.timerNext->timerPrev = &out;
+        out.timerPrev->timerNext = &out;
+        clear(list);
+    }
+
+    // 按到期时刻(不早于earliest)与当前时刻最高的不同位决定层级：同一个64ms块内放第0层，依此类推
+    void place(Node* node, uint64_t earliest)
+    {
+        uint64_t when = std::max(node->expireAt, earliest);
+        uint64_t diff = when ^ current_;
+        for (int level = 0; level < kLevels; ++level)
+        {
+            if (diff < (1ULL << (kBits * (level + 1))))
+            {
+                size_t slot = (when >> (kBits * level)) & kMask;
+                append(slots_[level][slot], node);
+                occupied_[level] |= 1ULL << slot;
+                return;
+            }
+        }
+        append(overflow_, node);
+    }
+
+    // 到达某层的块边界时，把该层对应槽中的节点按新的当前时刻重新放置(落到更低的层)
+    void cascade(uint64_t tick)
+    {
+        if ((tick & kMask) != 0) return;
+
+        if ((tick & ((1ULL << (kBits * kLevels)) - 1)) == 0 && !isEmpty(overflow_))
+        {
+            TimerLink nodes;
+            takeAll(overflow_, nodes);
+            replace(nodes, tick);
+        }
+        for (int level = kLevels - 1; level >= 1; --level)
+        {
+            if ((tick & ((1ULL << (kBits * level)) - 1)) != 0) continue;
+
+            size_t slot = (tick >> (kBits * level)) & kMask;
+            occupied_[level] &= ~(1ULL << slot);
+            if (isEmpty(slots_[level][slot])) continue;
+            TimerLink nodes;
+            takeAll(slots_[level][slot], nodes);
+            replace(nodes, tick);
+        }
+    }
+
+    void replace(TimerLink& nodes, uint64_t tick)
+    {
+        while (!isEmpty(nodes))
+        {
+            TimerLink* link = nodes.timerNext;
+            unlink(link);
+            place(static_cast<Node*>(link), tick);
+        }
+    }
+
+    // 到期的节点先移到局部链表：expire删除缓存条目时可能撤销同一批里的其它节点
+    template<typename Expire>
+    void fire(size_t slot, Expire& expire)
+    {
+        occupied_[0] &= ~(1ULL << slot);
+        if (isEmpty(slots_[0][slot])) return;
+
+        TimerLink due;
+        takeAll(slots_[0][slot], due);
+        while (!isEmpty(due))
+        {
+            TimerLink* link = due.timerNext;
+            unlink(link);
+            --count_;
+            expire(static_cast<Node*>(link));
+        }
+    }
+
+private:
+    uint64_t current_; // 已经推进到的时刻(毫秒)，不晚于它的节点都已到期
+    size_t   count_;   // 已登记的节点数
+    std::array<std::array<TimerLink, kSlots>, kLevels> slots_; // 各槽链表的哨兵
+    std::array<uint64_t, kLevels> occupied_; // 各层可能非空的槽的位图
+    TimerLink overflow_;                     // 超出最高层范围的节点
+};
+
+} // namespace Cache
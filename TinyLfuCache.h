@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CachePolicy.h"
+#include "CacheStats.h"
+#include "CacheUtils.h"
+
+namespace Cache
+{
+
+namespace detail
+{
+
+// 近似访问频次统计：4位计数器的Count-Min Sketch，前面加一个门卫(doorkeeper)布隆过滤器
+// 每个key第一次出现只记在门卫里，第二次起才进入计数器，大量只访问一次的key不会占满计数器
+// 记录次数达到采样窗口(sampleSize)后所有计数器减半、门卫清空，让旧的热度逐渐衰减
+template<typename Key>
+class FrequencySketch
+{
+public:
+    explicit FrequencySketch(size_t capacity)
+        : sampleSize_(std::max<size_t>(10 * capacity, 16))
+        , size_(0)
+        , tableMask_(nextPowerOfTwo(std::max<size_t>(capacity, 1)) - 1)
+        , table_(tableMask_ + 1, 0)
+        , doorkeeperMask_(nextPowerOfTwo(4 * sampleSize_) - 1) // 一个窗口最多插入sampleSize个key，3个哈希约需每个4位
+        , doorkeeper_((doorkeeperMask_ + 1) / 64 + 1, 0)
+    {}
+
+    // 记录一次访问 | 本次记录触发了整体减半时返回true
+    // 每次记录都计入采样窗口，只进门卫的第一次也算，否则大量一次性key会把门卫填满而迟迟不清空
+    bool increment(const Key& key)
+    {
+        uint64_t h = hashKey(key);
+        if (doorkeeperAdd(h))
+        {
+            for (int i = 0; i < kDepth; ++i)
+            {
+                incrementAt(h, i);
+            }
+        }
+        if (++size_ >= sampleSize_)
+        {
+            reset();
+            return true;
+        }
+        return false;
+    }
+
+    // 估算访问次数(最大15 + 门卫中的1次)
+    int frequency(const Key& key) const
+    {
+        uint64_t h = hashKey(key);
+        int freq = kMaxCount;
+        for (int i = 0; i < kDepth; ++i)
+        {
+            freq = std::min(freq, counterAt(h, i));
+        }
+        return freq + (doorkeeperContains(h) ? 1 : 0);
+    }
+
+private:
+    static constexpr int      kDepth = 4;      // 哈希函数(行)数
+    static constexpr int      kMaxCount = 15;  // 4位计数器的上限
+    static constexpr uint64_t kResetMask = 0x7777777777777777ULL;
+    static constexpr uint64_t kOneMask = 0x1111111111111111ULL;
+
+    // 每个64位字放16个计数器，第i行只用字内第i组(4个)中的一个，4行的计数器互不重叠
+    static uint64_t rowHash(uint64_t h, int i)
+    {
+        return mixHash(h + 0x9e3779b97f4a7c15ULL * static_cast<uint64_t>(i + 1));
+    }
+
+    int counterShift(uint64_t rh, int i) const
+    {
+        return static_cast<int>(((static_cast<uint64_t>(i) << 2) + ((rh >> 32) & 3)) << 2);
+    }
+
+    int counterAt(uint64_t h, int i) const
+    {
+        uint64_t rh = rowHash(h, i);
+        return static_cast<int>((table_[rh & tableMask_] >> counterShift(rh, i)) & 0xF);
+    }
+
+    bool incrementAt(uint64_t h, int i)
+    {
+        uint64_t rh = rowHash(h, i);
+        uint64_t& word = table_[rh & tableMask_];
+        int shift = counterShift(rh, i);
+        if (((word >> shift) & 0xF) == kMaxCount) return false;
+        word += 1ULL << shift;
+        return true;
+    }
+
+    // 门卫用同一个哈希值的高低两半做双重哈希，取3个位 | key已在门卫中时返回true
+    bool doorkeeperAdd(uint64_t h)
+    {
+        bool present = true;
+        uint64_t a = h;
+        uint64_t b = (h >> 32) | 1;
+        for (int i = 0; i < 3; ++i, a += b)
+        {
+            uint64_t bit = a & doorkeeperMask_;
+            uint64_t mask = 1ULL << (bit & 63);
+            if (!(doorkeeper_[bit >> 6] & mask))
+            {
+                present = false;
+                doorkeeper_[bit >> 6] |= mask;
+            }
+        }
+        return present;
+    }
+
+    bool doorkeeperContains(uint64_t h) const
+    {
+        uint64_t a = h;
+        uint64_t b = (h >> 32) | 1;
+        for (int i = 0; i < 3; ++i, a += b)
+        {
+            uint64_t bit = a & doorkeeperMask_;
+            if (!(doorkeeper_[bit >> 6] & (1ULL << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    // 所有计数器减半；奇数计数器减半时各丢掉0.5，按此修正记录数
+    void reset()
+    {
+        size_t odd = 0;
+        for (uint64_t& word : table_)
+        {
+            odd += popCount(word & kOneMask);
+            word = (word >> 1) & kResetMask;
+        }
+        size_ = (size_ - (odd >> 2)) >> 1;
+        std::fill(doorkeeper_.begin(), doorkeeper_.end(), 0);
+    }
+
+private:
+    size_t                sampleSize_;     // 采样窗口，记录数达到它时整体减半
+    size_t                size_;           // 当前窗口内的记录数
+    uint64_t              tableMask_;
+    std::vector<uint64_t> table_;          // 计数器表
+    uint64_t              doorkeeperMask_;
+    std::vector<uint64_t> doorkeeper_;     // 门卫布隆过滤器的位图
+};
+
+} // namespace detail
+
+// W-TinyLFU：新条目先进入容量约1%的准入窗口(LRU)，主区为分段LRU(试用段 + 保护段，保护段占主区80%)
+// 窗口淘汰出的候选者要进入已满的主区时，与主区的淘汰者比较近似访问频次，
+// 只有候选者更热才替换掉淘汰者，否则丢弃候选者：只访问一次的key挤不掉真正的热点
+// 试用段中的条目再次命中后升入保护段，保护段超出时最久未访问的条目降回试用段
+template<typename Key, typename Value>
+class TinyLfuCache : public CachePolicy<Key, Value>
+{
+public:
+    explicit TinyLfuCache(int capacity)
+        : capacity_(capacity > 0 ? static_cast<size_t>(capacity) : 0)
+        , windowCapacity_(std::max<size_t>(capacity_ / 100, capacity_ > 0 ? 1 : 0))
+        , protectedCapacity_((capacity_ - windowCapacity_) * 4 / 5)
+        , sketch_(capacity_)
+    {}
+
+    ~TinyLfuCache() override = default;
+
+    void put(const Key& key, const Value& value) override
+    {
+        emplace(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        emplace(key, std::move(value));
+    }
+
+    // 就地构造value，已存在则更新
+    template<typename... Args>
+    void emplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return;
+
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end())
+        {
+            stats_.add(detail::Stat::Update);
+            detail::assignValue(it->second->value, std::forward<Args>(args)...);
+            onHit(it->second);
+            return;
+        }
+        insertNew(key, std::forward<Args>(args)...);
+    }
+
+    // 仅在key不存在时插入 | 插入成功返回true
+    template<typename... Args>
+    bool tryEmplace(const Key& key, Args&&... args)
+    {
+        if (capacity_ == 0) return false;
+
+        auto lock = stats_.lock(mutex_);
+        if (index_.find(key) != index_.end()) return false;
+        insertNew(key, std::forward<Args>(args)...);
+        return true;
+    }
+
+    bool get(const Key& key, Value& value) override
+    {
+        return visit(key, [&value](const Value& v) { value = v; });
+    }
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        visit(key, [&value](const Value& v) { value = v; });
+        return value;
+    }
+
+    bool visit(const Key& key, const std::function<void(const Value&)>& visitor) override
+    {
+        return visit<const std::function<void(const Value&)>&>(key, visitor);
+    }
+
+    // 命中时在锁内以只读引用调用visitor
+    template<typename Visitor>
+    bool visit(const Key& key, Visitor&& visitor)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end())
+        {
+            stats_.add(detail::Stat::Miss);
+            return false;
+        }
+
+        stats_.add(detail::Stat::Hit);
+        onHit(it->second);
+        visitor(static_cast<const Value&>(it->second->value));
+        return true;
+    }
+
+    void remove(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        auto it = index_.find(key);
+        if (it == index_.end()) return;
+
+        listOf(it->second->segment).erase(it->second);
+        index_.erase(it);
+    }
+
+    size_t size()
+    {
+        auto lock = stats_.lock(mutex_);
+        return index_.size();
+    }
+
+    // 估算key的访问频次，用于观察准入决策
+    int frequency(const Key& key)
+    {
+        auto lock = stats_.lock(mutex_);
+        return sketch_.frequency(key);
+    }
+
+    // 准入被拒的候选者同样计入evictions，计数器整体减半计为agingPasses
+    CacheStats stats() override
+    {
+        return stats_.snapshot();
+    }
+
+private:
+    enum class Segment : uint8_t
+    {
+        Window,
+        Probation,
+        Protected
+    };
+
+    struct Node
+    {
+        template<typename... Args>
+        explicit Node(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...) {}
+
+        Key     key;
+        Value   value;
+        Segment segment = Segment::Window;
+    };
+
+    using List = std::list<Node>;
+    using ListIterator = typename List::iterator;
+
+    List& listOf(Segment segment)
+    {
+        switch (segment)
+        {
+            case Segment::Window:    return window_;
+            case Segment::Probation: return probation_;
+            default:                 return protected_;
+        }
+    }
+
+    // 需持有mutex_：命中(读或更新)时计入频次统计并调整位置
+    void onHit(ListIterator node)
+    {
+        recordAccess(node->key);
+        switch (node->segment)
+        {
+            case Segment::Window:
+                window_.splice(window_.begin(), window_, node);
+                break;
+            case Segment::Probation:
+                // 试用段再次命中升入保护段，保护段超出时把最久未访问的降回试用段
+                node->segment = Segment::Protected;
+                protected_.splice(protected_.begin(), probation_, node);
+                if (protected_.size() > protectedCapacity_)
+                {
+                    auto demoted = std::prev(protected_.end());
+                    demoted->segment = Segment::Probation;
+                    probation_.splice(probation_.begin(), protected_, demoted);
+                }
+                break;
+            case Segment::Protected:
+                protected_.splice(protected_.begin(), protected_, node);
+                break;
+        }
+    }
+
+    // 需持有mutex_：新条目进入窗口，窗口超出时把窗口的淘汰者交给准入策略
+    template<typename... Args>
+    void insertNew(const Key& key, Args&&... args)
+    {
+        stats_.add(detail::Stat::Insert);
+        recordAccess(key);
+        window_.emplace_front(key, std::forward<Args>(args)...);
+        index_.emplace(key, window_.begin());
+        if (window_.size() <= windowCapacity_) return;
+
+        auto candidate = std::prev(window_.end());
+        if (probation_.size() + protected_.size() < capacity_ - windowCapacity_)
+        {
+            // 主区未满，直接进入试用段
+            candidate->segment = Segment::Probation;
+            probation_.splice(probation_.begin(), window_, candidate);
+            return;
+        }
+
+        // 主区已满：候选者与主区的淘汰者(试用段队尾，试用段为空时取保护段队尾)比较频次
+        List& victimList = probation_.empty() ? protected_ : probation_;
+        if (victimList.empty())
+        {
+            evict(window_, candidate);
+            return;
+        }
+        auto victim = std::prev(victimList.end());
+        if (sketch_.frequency(candidate->key) > sketch_.frequency(victim->key))
+        {
+            evict(victimList, victim);
+            candidate->segment = Segment::Probation;
+            probation_.splice(probation_.begin(), window_, candidate);
+        }
+        else
+        {
+            evict(window_, candidate);
+        }
+    }
+
+    void recordAccess(const Key& key)
+    {
+        if (sketch_.increment(key))
+            stats_.add(detail::Stat::AgingPass);
+    }
+
+    void evict(List& list, ListIterator node)
+    {
+        stats_.add(detail::Stat::Eviction);
+        index_.erase(node->key);
+        list.erase(node);
+    }
+
+private:
+    size_t capacity_;
+    size_t windowCapacity_;    // 准入窗口的容量(约1%)
+    size_t protectedCapacity_; // 保护段的容量(主区的80%)，试用段占用主区剩余部分
+    std::mutex mutex_;
+    List window_;              // 准入窗口，头部最近访问
+    List probation_;           // 主区试用段
+    List protected_;           // 主区保护段
+    std::unordered_map<Key, ListIterator> index_;
+    detail::FrequencySketch<Key> sketch_;
+    detail::StatsCounter stats_;
+};
+
+} // namespace Cache
@@ -0,0 +1,76 @@
+#pragma once
+
+// 基准测试用的全局分配计数器：替换全局operator new/delete，统计当前存活的堆字节数
+// 只能被一个可执行程序中的单个翻译单元包含
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace Bench
+{
+
+inline std::atomic<long long> g_liveBytes{0};
+inline std::atomic<long long> g_allocCount{0};
+
+// 每块内存前面放一个头部记录大小，保证对齐
+constexpr size_t kAllocHeader = alignof(std::max_align_t);
+
+inline long long liveBytes() { return g_liveBytes.load(std::memory_order_relaxed); }
+inline long long allocCount() { return g_allocCount.load(std::memory_order_relaxed); }
+
+} // namespace Bench
+
+// 四个实际分配/释放的函数都禁止内联：只要有一侧被内联，编译器就会看到malloc返回值偏移后的指针
+// 被free，误报为数组越界和new/delete不匹配
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    void* raw = std::malloc(size + Bench::kAllocHeader);
+    if (!raw) throw std::bad_alloc();
+    *static_cast<size_t*>(raw) = size;
+    Bench::g_liveBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    Bench::g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(raw) + Bench::kAllocHeader;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    if (!p) return;
+    void* raw = static_cast<char*>(p) - Bench::kAllocHeader;
+    Bench::g_liveBytes.fetch_sub(static_cast<long long>(*static_cast<size_t*>(raw)), std::memory_order_relaxed);
+    std::free(raw);
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// 超对齐类型(alignas(64)等)走这一组重载
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t align)
+{
+    size_t a = static_cast<size_t>(align) < Bench::kAllocHeader ? Bench::kAllocHeader : static_cast<size_t>(align);
+    size_t total = (size + a + a - 1) / a * a;
+    void* raw = std::aligned_alloc(a, total);
+    if (!raw) throw std::bad_alloc();
+    char* user = static_cast<char*>(raw) + a;
+    *reinterpret_cast<size_t*>(user - sizeof(size_t)) = size;
+    Bench::g_liveBytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed);
+    Bench::g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    return user;
+}
+
+__attribute__((noinline)) void operator delete(void* p, std::align_val_t align) noexcept
+{
+    if (!p) return;
+    size_t a = static_cast<size_t>(align) < Bench::kAllocHeader ? Bench::kAllocHeader : static_cast<size_t>(align);
+    char* user = static_cast<char*>(p);
+    Bench::g_liveBytes.fetch_sub(static_cast<long long>(*reinterpret_cast<size_t*>(user - sizeof(size_t))), std::memory_order_relaxed);
+    std::free(user - a);
+}
+
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+void operator delete[](void* p, std::align_val_t align) noexcept { operator delete(p, align); }
+void operator delete(void* p, size_t, std::align_val_t align) noexcept { operator delete(p, align); }
+void operator delete[](void* p, size_t, std::align_val_t align) noexcept { operator delete(p, align); }
@@ -0,0 +1,209 @@
+#pragma once
+
+// 基准测试用的延迟直方图(HDR直方图式的对数-线性分桶)与低开销计时
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Bench
+{
+
+// 计时：x86上读TSC(rdtsc，开销约为steady_clock::now()的几分之一)，首次使用时对照steady_clock校准；
+// 其它平台直接用steady_clock的纳秒数
+// 依赖不变TSC(近十年的x86处理器都满足)，只用于计算间隔
+class TickClock
+{
+public:
+    static uint64_t now()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // 把两次now()之间的差值换算成纳秒
+    static uint64_t toNs(uint64_t ticks)
+    {
+        return static_cast<uint64_t>(ticks * nsPerTick());
+    }
+
+    static double nsPerTick()
+    {
+        static const double ratio = calibrate();
+        return ratio;
+    }
+
+private:
+    static double calibrate()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wallStart = std::chrono::steady_clock::now();
+        uint64_t tickStart = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t ticks = __rdtsc() - tickStart;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wallStart).count();
+        return ticks ? ns / ticks : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+// 对数-线性分桶的延迟直方图，单位纳秒：
+// 小于64的值每个值一个桶；更大的值按2的幂分段，每段再等分为64个桶，相对误差不超过1/64(约1.6%)
+// 覆盖整个uint64范围，共3776个桶(约30KB)，记录一次只是一次移位和一次自增，没有分配
+// 不做同步：每个线程各用一个，结束后用merge/+=合并
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()
+    {
+        reset();
+    }
+
+    void record(uint64_t ns)
+    {
+        ++counts_[bucketOf(ns)];
+        ++count_;
+        sum_ += ns;
+        min_ = std::min(min_, ns);
+        max_ = std::max(max_, ns);
+    }
+
+    // 对[start, now())计时并记录，start来自TickClock::now()
+    void recordSince(uint64_t startTicks)
+    {
+        record(TickClock::toNs(TickClock::now() - startTicks));
+    }
+
+    LatencyHistogram& operator+=(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < kBuckets; ++i)
+        {
+            counts_[i] += other.counts_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        return *this;
+    }
+
+    void merge(const LatencyHistogram& other) { *this += other; }
+
+    void reset()
+    {
+        counts_.fill(0);
+        count_ = 0;
+        sum_ = 0;
+        min_ = UINT64_MAX;
+        max_ = 0;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / count_ : 0.0; }
+
+    // 第percentile百分位(0~100)的延迟：返回该样本所在桶的上界，不超过实际最大值
+    uint64_t percentile(double percentile) const
+    {
+        if (count_ == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5);
+        rank = std::max<uint64_t>(1, std::min(rank, count_));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i)
+        {
+            seen += counts_[i];
+            if (seen >= rank)
+                return std::min(upperBound(i), max_);
+        }
+        return max_;
+    }
+
+private:
+    static constexpr unsigned kSubBits = 6;
+    static constexpr uint64_t kSubCount = 1ull << kSubBits;
+    static constexpr size_t   kBuckets = kSubCount + (64 - kSubBits) * kSubCount;
+
+    static size_t bucketOf(uint64_t v)
+    {
+        if (v < kSubCount) return static_cast<size_t>(v);
+        unsigned exponent = 63 - __builtin_clzll(v);     // v落在[2^exponent, 2^(exponent+1))
+        unsigned shift = exponent - kSubBits;
+        return static_cast<size_t>(kSubCount + shift * kSubCount + ((v >> shift) - kSubCount));
+    }
+
+    static uint64_t upperBound(size_t bucket)
+    {
+        if (bucket < kSubCount) return bucket;
+        uint64_t shift = (bucket - kSubCount) / kSubCount;
+        uint64_t sub = (bucket - kSubCount) % kSubCount + kSubCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::array<uint64_t, kBuckets> counts_;
+    uint64_t count_;
+    uint64_t sum_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+// 一次操作类型的延迟：get和put分开统计
+struct OpLatency
+{
+    LatencyHistogram get;
+    LatencyHistogram put;
+
+    OpLatency& operator+=(const OpLatency& other)
+    {
+        get += other.get;
+        put += other.put;
+        return *this;
+    }
+};
+
+// 延迟表：表头与每行(名称、操作类型、样本数、p50/p90/p99/p99.9/最大值，单位纳秒)
+inline void printLatencyHeader(std::ostream& out, int nameWidth = 16)
+{
+    out << std::left << std::setw(nameWidth) << "policy" << std::setw(6) << "op"
+        << std::right << std::setw(10) << "count"
+        << std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(9) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(11) << "max" << "  (ns)" << std::endl;
+}
+
+inline void printLatencyRow(std::ostream& out, const std::string& name, const std::string& op,
+                            const LatencyHistogram& histogram, int nameWidth = 16)
+{
+    if (histogram.count() == 0) return;
+    out << std::left << std::setw(nameWidth) << name << std::setw(6) << op
+        << std::right << std::setw(10) << histogram.count()
+        << std::setw(9) << histogram.percentile(50)
+        << std::setw(9) << histogram.percentile(90)
+        << std::setw(9) << histogram.percentile(99)
+        << std::setw(10) << histogram.percentile(99.9)
+        << std::setw(11) << histogram.max() << std::endl;
+}
+
+inline void printLatencyRows(std::ostream& out, const std::string& name, const OpLatency& latency,
+                             int nameWidth = 16)
+{
+    printLatencyRow(out, name, "get", latency.get, nameWidth);
+    printLatencyRow(out, name, "put", latency.put, nameWidth);
+}
+
+} // namespace Bench
@@ -0,0 +1,405 @@
+#pragma once
+
+// 访问轨迹(trace)的读取：整个文件以只读方式mmap，按记录顺序流式解码，不把轨迹读进内存
+// 多个线程可以各自用一个TraceReader同时读同一个MappedFile
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Bench
+{
+
+enum class TraceOp : uint8_t
+{
+    Get = 0,   // 读：命中计入命中率，未命中时由模拟器写入缓存
+    Put = 1    // 写：直接写入缓存，不计入命中率
+};
+
+struct TraceRecord
+{
+    uint64_t key;
+    uint32_t size;  // 对象字节数，格式中没有大小时取TraceOptions::defaultSize
+    TraceOp  op;
+};
+
+// 轨迹格式：
+// Binary: 本项目的二进制格式，16字节文件头(8字节魔数"CTRACE01" + uint32版本号 + uint32记录字节数)，
+//         之后是定长的小端记录 {uint64 key; uint32 size; uint8 op; uint8 pad[3]}
+// Text:   本项目的文本格式，每行"op key [size]"，op为get/g/r/read或set/put/s/p/w/write
+// Keys:   每行一个key(LIRS等论文轨迹的格式)，空行和以#、*开头的行跳过
+// Arc:    ARC论文轨迹(Megiddo & Modha)，每行"起始块号 块数 忽略 请求号"，展开为连续的块号，大小取defaultSize
+// Csv:    逗号分隔的块轨迹(如MSR Cambridge)，key/size/op所在列由TraceOptions指定
+// key不是纯十进制数字时取其FNV-1a哈希
+enum class TraceFormat
+{
+    Binary,
+    Text,
+    Keys,
+    Arc,
+    Csv
+};
+
+struct TraceOptions
+{
+    TraceFormat format = TraceFormat::Keys;
+    uint32_t    defaultSize = 1;
+    int         csvKeyColumn = 0;
+    int         csvSizeColumn = -1;  // -1表示没有该列
+    int         csvOpColumn = -1;
+    bool        csvHeader = false;   // 跳过第一行
+};
+
+constexpr char     kTraceMagic[8] = {'C', 'T', 'R', 'A', 'C', 'E', '0', '1'};
+constexpr uint32_t kTraceVersion = 1;
+constexpr size_t   kTraceHeaderBytes = 16;
+constexpr size_t   kTraceRecordBytes = 16;
+
+// 只读映射的文件；映射失败时抛出std::runtime_error
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path)
+        : data_(nullptr)
+        , size_(0)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("无法打开轨迹文件: " + path);
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("无法读取轨迹文件大小: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0)
+        {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("无法映射轨迹文件: " + path);
+            }
+            // 顺序读取：让内核提前读入后面的页，读过的页可以尽早回收
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(p);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // 是否为本项目的二进制轨迹格式
+    bool isBinaryTrace() const
+    {
+        return size_ >= kTraceHeaderBytes && std::memcmp(data_, kTraceMagic, sizeof(kTraceMagic)) == 0;
+    }
+
+private:
+    const char* data_;
+    size_t      size_;
+};
+
+// 按顺序解码一个映射文件中的记录，自身只保存游标，可以为每个线程各建一个
+class TraceReader
+{
+public:
+    TraceReader(const MappedFile& file, const TraceOptions& options)
+        : options_(options)
+        , pos_(file.data())
+        , end_(file.data() + file.size())
+        , arcNext_(0)
+        , arcRemaining_(0)
+    {
+        if (options_.format == TraceFormat::Binary)
+        {
+            if (!file.isBinaryTrace())
+                throw std::runtime_error("不是二进制轨迹文件(魔数不匹配)");
+            uint32_t version, recordBytes;
+            std::memcpy(&version, pos_ + 8, 4);
+            std::memcpy(&recordBytes, pos_ + 12, 4);
+            if (version != kTraceVersion || recordBytes != kTraceRecordBytes)
+                throw std::runtime_error("不支持的二进制轨迹版本");
+            pos_ += kTraceHeaderBytes;
+        }
+        else if (options_.format == TraceFormat::Csv && options_.csvHeader)
+        {
+            skipLine();
+        }
+    }
+
+    // 读出下一条记录 | 读完时返回false
+    bool next(TraceRecord& record)
+    {
+        switch (options_.format)
+        {
+        case TraceFormat::Binary: return nextBinary(record);
+        case TraceFormat::Text:   return nextText(record);
+        case TraceFormat::Keys:   return nextKey(record);
+        case TraceFormat::Arc:    return nextArc(record);
+        case TraceFormat::Csv:    return nextCsv(record);
+        }
+        return false;
+    }
+
+private:
+    bool nextBinary(TraceRecord& record)
+    {
+        if (end_ - pos_ < static_cast<ptrdiff_t>(kTraceRecordBytes))
+            return false;
+        uint8_t op;
+        std::memcpy(&record.key, pos_, 8);
+        std::memcpy(&record.size, pos_ + 8, 4);
+        std::memcpy(&op, pos_ + 12, 1);
+        record.op = op == static_cast<uint8_t>(TraceOp::Put) ? TraceOp::Put : TraceOp::Get;
+        pos_ += kTraceRecordBytes;
+        return true;
+    }
+
+    bool nextText(TraceRecord& record)
+    {
+        while (pos_ < end_)
+        {
+            const char* lineEnd = findLineEnd();
+            const char* p = pos_;
+            Token op = token(p, lineEnd, ' ');
+            Token key = token(p, lineEnd, ' ');
+            Token size = token(p, lineEnd, ' ');
+            pos_ = lineEnd < end_ ? lineEnd + 1 : end_;
+            if (key.empty() || op.begin[0] == '#')
+                continue;
+            record.op = parseOp(op);
+            record.key = parseKey(key);
+            record.size = size.empty() ? options_.defaultSize : static_cast<uint32_t>(parseNumber(size));
+            return true;
+        }
+        return false;
+    }
+
+    bool nextKey(TraceRecord& record)
+    {
+        while (pos_ < end_)
+        {
+            const char* lineEnd = findLineEnd();
+            const char* p = pos_;
+            Token key = token(p, lineEnd, ' ');
+            pos_ = lineEnd < end_ ? lineEnd + 1 : end_;
+            if (key.empty() || key.begin[0] == '#' || key.begin[0] == '*')
+                continue;
+            record.op = TraceOp::Get;
+            record.key = parseKey(key);
+            record.size = options_.defaultSize;
+            return true;
+        }
+        return false;
+    }
+
+    bool nextArc(TraceRecord& record)
+    {
+        while (arcRemaining_ == 0)
+        {
+            if (pos_ >= end_)
+                return false;
+            const char* lineEnd = findLineEnd();
+            const char* p = pos_;
+            Token start = token(p, lineEnd, ' ');
+            Token count = token(p, lineEnd, ' ');
+            pos_ = lineEnd < end_ ? lineEnd + 1 : end_;
+            if (start.empty() || count.empty())
+                continue;
+            arcNext_ = parseNumber(start);
+            arcRemaining_ = parseNumber(count);
+        }
+        record.op = TraceOp::Get;
+        record.key = arcNext_++;
+        record.size = options_.defaultSize;
+        --arcRemaining_;
+        return true;
+    }
+
+    bool nextCsv(TraceRecord& record)
+    {
+        while (pos_ < end_)
+        {
+            const char* lineEnd = findLineEnd();
+            const char* p = pos_;
+            Token key, size, op;
+            for (int column = 0; p <= lineEnd && p < end_; ++column)
+            {
+                Token field = token(p, lineEnd, ',');
+                if (column == options_.csvKeyColumn) key = field;
+                if (column == options_.csvSizeColumn) size = field;
+                if (column == options_.csvOpColumn) op = field;
+            }
+            pos_ = lineEnd < end_ ? lineEnd + 1 : end_;
+            if (key.empty())
+                continue;
+            record.key = parseKey(key);
+            record.size = size.empty() ? options_.defaultSize : static_cast<uint32_t>(parseNumber(size));
+            record.op = op.empty() ? TraceOp::Get : parseOp(op);
+            return true;
+        }
+        return false;
+    }
+
+    struct Token
+    {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+
+        bool empty() const { return begin == end; }
+    };
+
+    const char* findLineEnd() const
+    {
+        const void* nl = std::memchr(pos_, '\n', static_cast<size_t>(end_ - pos_));
+        return nl ? static_cast<const char*>(nl) : end_;
+    }
+
+    void skipLine()
+    {
+        const char* lineEnd = findLineEnd();
+        pos_ = lineEnd < end_ ? lineEnd + 1 : end_;
+    }
+
+    static bool isBlank(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    // 从p开始取下一个字段：sep为' '时以连续空白分隔，否则以sep分隔；去掉首尾空白，p移到字段之后
+    static Token token(const char*& p, const char* lineEnd, char sep)
+    {
+        Token t;
+        if (sep == ' ')
+        {
+            while (p < lineEnd && isBlank(*p)) ++p;
+            t.begin = p;
+            while (p < lineEnd && !isBlank(*p)) ++p;
+            t.end = p;
+            return t;
+        }
+        const char* fieldEnd = p;
+        while (fieldEnd < lineEnd && *fieldEnd != sep) ++fieldEnd;
+        t.begin = p;
+        t.end = fieldEnd;
+        while (t.begin < t.end && isBlank(*t.begin)) ++t.begin;
+        while (t.end > t.begin && isBlank(t.end[-1])) --t.end;
+        p = fieldEnd + 1;
+        return t;
+    }
+
+    static uint64_t parseNumber(Token t)
+    {
+        uint64_t v = 0;
+        for (const char* c = t.begin; c < t.end && *c >= '0' && *c <= '9'; ++c)
+        {
+            v = v * 10 + static_cast<uint64_t>(*c - '0');
+        }
+        return v;
+    }
+
+    static uint64_t parseKey(Token t)
+    {
+        uint64_t v = 0;
+        for (const char* c = t.begin; c < t.end; ++c)
+        {
+            if (*c < '0' || *c > '9')
+                return fnv1a(t);
+            v = v * 10 + static_cast<uint64_t>(*c - '0');
+        }
+        return v;
+    }
+
+    static uint64_t fnv1a(Token t)
+    {
+        uint64_t h = 14695981039346656037ull;
+        for (const char* c = t.begin; c < t.end; ++c)
+        {
+            h = (h ^ static_cast<uint8_t>(*c)) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // 写操作的各种写法(set/put/write/w/p/s，不分大小写)，其余都按读处理
+    static TraceOp parseOp(Token t)
+    {
+        if (t.empty()) return TraceOp::Get;
+        char c = static_cast<char>(t.begin[0] | 0x20);
+        return c == 's' || c == 'p' || c == 'w' ? TraceOp::Put : TraceOp::Get;
+    }
+
+private:
+    TraceOptions options_;
+    const char*  pos_;
+    const char*  end_;
+    uint64_t     arcNext_;      // Arc格式：当前行展开到的块号
+    uint64_t     arcRemaining_; // Arc格式：当前行还未展开的块数
+};
+
+// 以本项目的二进制格式写出轨迹
+class TraceWriter
+{
+public:
+    explicit TraceWriter(const std::string& path)
+        : file_(std::fopen(path.c_str(), "wb"))
+    {
+        if (!file_)
+            throw std::runtime_error("无法写入轨迹文件: " + path);
+        char header[kTraceHeaderBytes];
+        std::memcpy(header, kTraceMagic, sizeof(kTraceMagic));
+        std::memcpy(header + 8, &kTraceVersion, 4);
+        uint32_t recordBytes = kTraceRecordBytes;
+        std::memcpy(header + 12, &recordBytes, 4);
+        std::fwrite(header, 1, sizeof(header), file_);
+    }
+
+    ~TraceWriter()
+    {
+        if (file_) std::fclose(file_);
+    }
+
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+
+    void write(const TraceRecord& record)
+    {
+        char buf[kTraceRecordBytes] = {};
+        uint8_t op = static_cast<uint8_t>(record.op);
+        std::memcpy(buf, &record.key, 8);
+        std::memcpy(buf + 8, &record.size, 4);
+        std::memcpy(buf + 12, &op, 1);
+        std::fwrite(buf, 1, sizeof(buf), file_);
+    }
+
+    // 刷新并关闭 | 写入出错时返回false
+    bool close()
+    {
+        bool ok = std::fflush(file_) == 0 && !std::ferror(file_);
+        ok = std::fclose(file_) == 0 && ok;
+        file_ = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* file_;
+};
+
+} // namespace Bench
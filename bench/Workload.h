@@ -0,0 +1,52 @@
+#pragma once
+
+// 基准测试用的key分布生成器
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace Bench
+{
+
+// Zipf分布生成器(Gray等人的快速算法，YCSB同款)，返回[0, n)，0最热
+class ZipfGenerator
+{
+public:
+    ZipfGenerator(uint64_t n, double theta = 0.99)
+        : n_(n), theta_(theta), dist_(0.0, 1.0)
+    {
+        zetaN_ = zeta(n_, theta_);
+        double zeta2 = zeta(2, theta_);
+        alpha_ = 1.0 / (1.0 - theta_);
+        eta_ = (1.0 - std::pow(2.0 / n_, 1.0 - theta_)) / (1.0 - zeta2 / zetaN_);
+    }
+
+    template<typename Rng>
+    uint64_t operator()(Rng& rng)
+    {
+        double u = dist_(rng);
+        double uz = u * zetaN_;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta_)) return 1;
+        uint64_t v = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return v < n_ ? v : n_ - 1;
+    }
+
+private:
+    static double zeta(uint64_t n, double theta)
+    {
+        double sum = 0;
+        for (uint64_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    uint64_t n_;
+    double   theta_;
+    double   zetaN_;
+    double   alpha_;
+    double   eta_;
+    std::uniform_real_distribution<double> dist_;
+};
+
+} // namespace Bench
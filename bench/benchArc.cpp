@@ -0,0 +1,76 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+#include "AllocCounter.h"
+#include "ArcCache/ArcCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// ArcCache的每条目内存占用与混合读写吞吐量
+// 内存：写满容量后每个key再命中一次(进入T2)，再写入同样多的新key把它们挤进幽灵链表，
+//       分别统计只有缓存条目、以及缓存条目加满幽灵链表时的存活堆字节数
+// 吞吐量：与test/testArc.cpp的压力测试/性能测试相同的负载(key空间为容量的两倍，70%写入)
+
+void footprint(int capacity)
+{
+    long long before = Bench::liveBytes();
+    auto* cache = new ArcCache<int, int>(capacity, 2);
+    int value = 0;
+    for (int i = 0; i < capacity; ++i) cache->put(i, i);
+    for (int i = 0; i < capacity; ++i) cache->get(i, value);
+    double resident = static_cast<double>(Bench::liveBytes() - before) / capacity;
+    for (int i = capacity; i < capacity * 2; ++i) cache->put(i, i);
+    double withGhosts = static_cast<double>(Bench::liveBytes() - before) / capacity;
+    delete cache;
+
+    cout << left << setw(10) << capacity << fixed << setprecision(1)
+         << setw(18) << resident << setw(18) << withGhosts << endl;
+}
+
+void throughput(int capacity, int operations, int putPercent)
+{
+    ArcCache<int, int> cache(capacity, 3);
+    mt19937 gen(42);
+    uniform_int_distribution<> keyDis(0, capacity * 2);
+    uniform_int_distribution<> opDis(0, 99);
+    vector<int> keys(operations);
+    vector<bool> isPut(operations);
+    for (int i = 0; i < operations; ++i) {
+        keys[i] = keyDis(gen);
+        isPut[i] = opDis(gen) < putPercent;
+    }
+
+    long long hits = 0;
+    int value = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i) {
+        if (isPut[i]) {
+            cache.put(keys[i], keys[i] * 2);
+        } else if (cache.get(keys[i], value)) {
+            ++hits;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << left << setw(10) << capacity << fixed << setprecision(0)
+         << setw(18) << operations / seconds << setw(10) << hits << endl;
+}
+
+int main() {
+    cout << "=== ArcCache每条目字节数 (key/value均为int) ===" << endl;
+    cout << left << setw(10) << "capacity" << setw(18) << "缓存条目" << setw(18) << "含满幽灵链表" << endl;
+    for (int capacity : {1000, 10000, 100000}) {
+        footprint(capacity);
+    }
+
+    cout << "\n=== 混合读写吞吐量 (70%写入，key空间为容量的两倍) ===" << endl;
+    cout << left << setw(10) << "capacity" << setw(18) << "ops/sec" << setw(10) << "get命中" << endl;
+    for (int capacity : {500, 5000, 100000}) {
+        throughput(capacity, 1000000, 70);
+    }
+    return 0;
+}
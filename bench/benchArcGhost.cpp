@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+
+#include "AllocCounter.h"
+#include "ArcCache/ArcCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 大value下ARC幽灵链表的内存占用：写满容量并全部命中一次(进入T2)，
+// 再写入两倍容量的新key，把原有条目全部挤进幽灵链表(B1/B2)，
+// 分别报告进程RSS和存活的堆字节数；幽灵链表不保留value时，挤出后的内存应与写满时相当
+// 用法: benchArcGhost [容量] [value字节数]
+
+const int kDefaultCapacity = 500;
+const size_t kDefaultValueBytes = 256 * 1024; // 超过glibc的mmap阈值，释放后立即归还系统，RSS能反映真实占用
+
+// 当前进程的常驻内存(MB)，读取/proc/self/status，非Linux平台返回-1
+double rssMb()
+{
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return stod(line.substr(6)) / 1024.0;
+        }
+    }
+    return -1;
+}
+
+void report(const string& stage, double baseRss, long long baseHeap)
+{
+    cout << left << setw(28) << stage << fixed << setprecision(1)
+         << "RSS: " << setw(10) << rssMb() - baseRss << "MB  "
+         << "堆: " << setw(10) << (Bench::liveBytes() - baseHeap) / (1024.0 * 1024.0) << "MB" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int capacity = argc > 1 ? atoi(argv[1]) : kDefaultCapacity;
+    size_t valueBytes = argc > 2 ? static_cast<size_t>(atoll(argv[2])) : kDefaultValueBytes;
+
+    cout << "=== ArcCache幽灵链表内存占用 (容量 " << capacity << ", value " << valueBytes / 1024 << "KB) ===" << endl;
+    double baseRss = rssMb();
+    long long baseHeap = Bench::liveBytes();
+    {
+        ArcCache<int, string> cache(capacity, 2);
+        string value;
+        for (int i = 0; i < capacity; ++i) {
+            cache.put(i, string(valueBytes, 'v'));
+        }
+        for (int i = 0; i < capacity; ++i) {
+            cache.get(i, value);
+        }
+        value.clear();
+        value.shrink_to_fit();
+        report("写满容量", baseRss, baseHeap);
+
+        for (int i = capacity; i < capacity * 3; ++i) {
+            cache.put(i, string(valueBytes, 'v'));
+        }
+        report("挤出到幽灵链表后", baseRss, baseHeap);
+
+        // 命中幽灵链表的key重新写入，验证自适应仍然生效
+        int ghostHits = 0;
+        for (int i = 0; i < capacity; ++i) {
+            if (!cache.get(i, value)) {
+                cache.put(i, string(valueBytes, 'v'));
+                ++ghostHits;
+            }
+        }
+        report("幽灵key重新写入后", baseRss, baseHeap);
+    }
+    report("析构后", baseRss, baseHeap);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+
+#include "ArcCache/ArcCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// ARC的T2(LFU部分)在大量key处于同一访问频率时的命中开销
+// 先写入n个key并全部命中一次(达到转换门槛，全部进入T2的频率1桶)，再按随机顺序逐个命中一次：
+// 每次命中都会把一个key从(还剩很多节点的)频率1桶升到频率2桶，升频是O(1)时每次命中的耗时不随n增长
+
+void runSameFrequency(int n)
+{
+    ArcCache<int, int> cache(n, 2);
+    for (int i = 0; i < n; ++i) {
+        cache.put(i, i);
+    }
+
+    vector<int> order(n);
+    for (int i = 0; i < n; ++i) order[i] = i;
+    shuffle(order.begin(), order.end(), mt19937(42));
+
+    int value = 0;
+    for (int key : order) {
+        cache.get(key, value);
+    }
+
+    shuffle(order.begin(), order.end(), mt19937(7));
+    long long hits = 0;
+    auto start = chrono::steady_clock::now();
+    for (int key : order) {
+        if (cache.get(key, value)) ++hits;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << left << setw(10) << n << fixed << setprecision(1)
+         << setw(14) << seconds * 1e9 / n
+         << setw(10) << hits << endl;
+}
+
+int main() {
+    cout << "=== ArcCache: T2中所有key处于频率1时的命中开销 ===" << endl;
+    cout << left << setw(10) << "keys" << setw(14) << "ns/hit" << setw(10) << "hits" << endl;
+    for (int n : {1000, 10000, 100000, 1000000}) {
+        runSameFrequency(n);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+
+#include "ArcCache/ArcCache.h"
+#include "LatencyHistogram.h"
+
+using namespace Cache;
+using namespace std;
+
+// ARC线程扩展性测试：沿用test/testArc.cpp中testThreadSafety的负载
+// (容量1000，key取自[0,200)，一半put一半get，每50次写入并读回本线程私有的key)，
+// 在1~64线程下对比单个ArcCache与分片HashArcCache(独立/共享p)的吞吐量，
+// 并给出各线程合并后的get/put延迟分布(锁排队体现在尾部)
+// 用法: benchArcScaling [每线程操作数] [分片数]，默认20万次、16个分片
+
+const int kCapacity = 1000;
+const int kKeySpace = 200;
+
+// 预先生成每个线程的key序列，计时区间内不做随机数生成
+vector<vector<int>> makeKeys(int threads, int operationsPerThread)
+{
+    vector<vector<int>> keys(threads);
+    for (int t = 0; t < threads; ++t) {
+        mt19937 gen(42 + t);
+        uniform_int_distribution<> dis(0, kKeySpace - 1);
+        keys[t].resize(operationsPerThread);
+        for (int& key : keys[t]) key = dis(gen);
+    }
+    return keys;
+}
+
+// latency传出各线程合并后的延迟分布
+template<typename CacheType>
+double runThreads(CacheType& cache, const vector<vector<int>>& keys, atomic<bool>& ok, Bench::OpLatency& latency)
+{
+    int threads = static_cast<int>(keys.size());
+    atomic<bool> go{false};
+    vector<thread> workers;
+    vector<Bench::OpLatency> perThread(threads);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            const vector<int>& mine = keys[t];
+            Bench::OpLatency& mineLatency = perThread[t];
+            int value;
+            for (size_t i = 0; i < mine.size(); ++i) {
+                int key = mine[i];
+                uint64_t start = Bench::TickClock::now();
+                if (i % 2 == 0) {
+                    cache.put(key, key * 10 + t);
+                    mineLatency.put.recordSince(start);
+                } else {
+                    cache.get(key, value);
+                    mineLatency.get.recordSince(start);
+                }
+                if (i % 50 == 0) {
+                    int testKey = t + 1000;
+                    cache.put(testKey, t);
+                    if (!cache.get(testKey, value) || value != t) ok = false;
+                }
+            }
+        });
+    }
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& w : workers) w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (const Bench::OpLatency& l : perThread) latency += l;
+
+    size_t operations = 0;
+    for (const auto& k : keys) operations += k.size() + k.size() / 50 * 2;
+    return operations / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    int operationsPerThread = argc > 1 ? atoi(argv[1]) : 200000;
+    int slices = argc > 2 ? atoi(argv[2]) : 16;
+
+    cout << "=== ARC线程扩展性 (容量 " << kCapacity << ", key空间 " << kKeySpace
+         << ", 每线程 " << operationsPerThread << " 次操作, 分片数 " << slices
+         << ", CPU核数 " << thread::hardware_concurrency() << ") ===" << endl;
+    cout << left << setw(11) << "线程数"
+         << setw(20) << "ArcCache"
+         << setw(20) << "HashArc(独立p)"
+         << setw(20) << "HashArc(共享p)" << " (ops/sec)" << endl;
+
+    atomic<bool> ok{true};
+    vector<pair<string, Bench::OpLatency>> latencies;
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        vector<vector<int>> keys = makeKeys(threads, operationsPerThread);
+
+        ArcCache<int, int> single(kCapacity, 2);
+        HashArcCache<int, int> perShard(kCapacity, slices, 2);
+        HashArcCache<int, int> shared(kCapacity, slices, 2, ArcAdaptation::Shared);
+
+        Bench::OpLatency singleLatency, perShardLatency, sharedLatency;
+        double singleOps = runThreads(single, keys, ok, singleLatency);
+        double perShardOps = runThreads(perShard, keys, ok, perShardLatency);
+        double sharedOps = runThreads(shared, keys, ok, sharedLatency);
+        string suffix = "/" + to_string(threads) + "t";
+        latencies.emplace_back("ArcCache" + suffix, singleLatency);
+        latencies.emplace_back("HashArc-p" + suffix, perShardLatency);
+        latencies.emplace_back("HashArc-sp" + suffix, sharedLatency);
+        cout << left << setw(8) << threads << fixed << setprecision(0)
+             << setw(20) << singleOps
+             << setw(20) << perShardOps
+             << setw(20) << sharedOps << endl;
+    }
+    cout << "\n延迟分布 (HashArc-p: 独立p, HashArc-sp: 共享p)" << endl;
+    Bench::printLatencyHeader(cout, 18);
+    for (const auto& entry : latencies) Bench::printLatencyRows(cout, entry.first, entry.second, 18);
+
+    cout << "\n私有key读回校验: " << (ok ? "通过" : "失败") << endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "ArcCache/ArcCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 批量读取：逐个get vs getMany，模拟一次请求查20~200个key的场景
+// 用法: benchBatch [线程数]
+
+const int kCapacity = 200000;
+const int kKeySpace = 250000;
+const size_t kKeysPerThread = 200000;
+
+// 预先生成每个线程的请求，每个请求包含一批key
+vector<vector<vector<int>>> makeRequests(int threads, size_t batchSize)
+{
+    vector<vector<vector<int>>> requests(threads);
+    for (int t = 0; t < threads; ++t) {
+        mt19937 gen(100 + t);
+        uniform_int_distribution<> dis(0, kKeySpace - 1);
+        requests[t].resize(kKeysPerThread / batchSize);
+        for (auto& keys : requests[t]) {
+            keys.resize(batchSize);
+            for (int& key : keys) key = dis(gen);
+        }
+    }
+    return requests;
+}
+
+template<typename CacheType>
+void fill(CacheType& cache)
+{
+    vector<int> keys(kCapacity);
+    for (int i = 0; i < kCapacity; ++i) keys[i] = i;
+    cache.putMany(keys, keys);
+}
+
+// batched为true时每个请求调用一次getMany，否则逐个get | 返回每秒查询的key数
+template<typename CacheType>
+double run(CacheType& cache, const vector<vector<vector<int>>>& requests, bool batched)
+{
+    atomic<bool> go{false};
+    vector<thread> workers;
+    for (size_t t = 0; t < requests.size(); ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            vector<int> values;
+            vector<bool> found;
+            for (const vector<int>& keys : requests[t]) {
+                if (batched) {
+                    cache.getMany(keys, values, found);
+                } else {
+                    values.resize(keys.size());
+                    for (size_t i = 0; i < keys.size(); ++i) cache.get(keys[i], values[i]);
+                }
+            }
+        });
+    }
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& w : workers) w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return requests.size() * requests[0].size() * requests[0][0].size() / seconds;
+}
+
+template<typename CacheType>
+void compare(const string& name, CacheType& cache, const vector<vector<vector<int>>>& requests)
+{
+    fill(cache);
+    double single = run(cache, requests, false);
+    double batched = run(cache, requests, true);
+    cout << left << setw(16) << name << fixed << setprecision(0)
+         << setw(16) << single << setw(16) << batched
+         << setprecision(2) << batched / single << "x" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? max(1, atoi(argv[1])) : max(1u, thread::hardware_concurrency());
+    int slices = max(1u, thread::hardware_concurrency());
+
+    for (size_t batchSize : {20, 200}) {
+        vector<vector<vector<int>>> requests = makeRequests(threads, batchSize);
+        cout << "\n=== 每请求 " << batchSize << " 个key, " << threads << " 线程 (keys/sec) ===" << endl;
+        cout << left << setw(16) << "cache" << setw(16) << "get" << setw(16) << "getMany" << "加速比" << endl;
+
+        LRUCache<int, int> lru(kCapacity);
+        LFUCache<int, int> lfu(kCapacity);
+        ArcCache<int, int> arc(kCapacity);
+        HashLruCaches<int, int> hashLru(kCapacity, slices);
+        KHashLfuCache<int, int> hashLfu(kCapacity, slices, 1000000);
+        compare("LRU", lru, requests);
+        compare("LFU", lfu, requests);
+        compare("ARC", arc, requests);
+        compare("HashLRU", hashLru, requests);
+        compare("HashLFU", hashLfu, requests);
+    }
+    return 0;
+}
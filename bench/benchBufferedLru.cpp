@@ -0,0 +1,98 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <functional>
+#include <cstdlib>
+
+#include "LRUCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 读多写少场景下的多线程吞吐量：普通LRUCache vs 读缓冲模式，以及对应的分片缓存
+// 用法: benchBufferedLru [最大线程数]
+
+const int kCapacity = 100000;
+const int kKeySpace = 120000;
+const int kOpsPerThread = 1000000;
+const int kWritePercent = 5;
+
+// 每个线程预先生成自己的key序列
+vector<vector<int>> makeKeyStreams(int threads)
+{
+    vector<vector<int>> streams(threads);
+    for (int t = 0; t < threads; ++t) {
+        mt19937 gen(1000 + t);
+        uniform_int_distribution<> dis(0, kKeySpace - 1);
+        streams[t].resize(kOpsPerThread);
+        for (int& key : streams[t]) key = dis(gen);
+    }
+    return streams;
+}
+
+template<typename CacheType>
+double runThreads(CacheType& cache, const vector<vector<int>>& streams)
+{
+    for (int key = 0; key < kCapacity; ++key) {
+        cache.put(key, key);
+    }
+
+    atomic<bool> go{false};
+    vector<thread> threads;
+    for (size_t t = 0; t < streams.size(); ++t) {
+        threads.emplace_back([&, t]() {
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            const vector<int>& keys = streams[t];
+            int value = 0;
+            for (int i = 0; i < kOpsPerThread; ++i) {
+                if (i % 100 < kWritePercent) {
+                    cache.put(keys[i], i);
+                } else {
+                    cache.get(keys[i], value);
+                }
+            }
+        });
+    }
+
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& th : threads) th.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return streams.size() * static_cast<double>(kOpsPerThread) / seconds;
+}
+
+int main(int argc, char* argv[]) {
+    int maxThreads = argc > 1 ? atoi(argv[1]) : static_cast<int>(thread::hardware_concurrency());
+    if (maxThreads <= 0) maxThreads = 1;
+    int slices = static_cast<int>(thread::hardware_concurrency());
+
+    cout << "=== 读缓冲LRU多线程吞吐量测试 (读:写 = " << 100 - kWritePercent << ":" << kWritePercent << ") ===" << endl;
+    cout << left << setw(8) << "threads"
+         << setw(18) << "LRU"
+         << setw(18) << "LRU-Buffered"
+         << setw(18) << "HashLRU"
+         << setw(18) << "HashLRU-Buffered" << "(ops/sec)" << endl;
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        vector<vector<int>> streams = makeKeyStreams(threads);
+
+        LRUCache<int, int> lru(kCapacity);
+        LRUCache<int, int> lruBuffered(kCapacity, true);
+        HashLruCaches<int, int> hashLru(kCapacity, slices);
+        HashLruCaches<int, int> hashLruBuffered(kCapacity, slices, true);
+
+        cout << left << setw(8) << threads << fixed << setprecision(0)
+             << setw(18) << runThreads(lru, streams)
+             << setw(18) << runThreads(lruBuffered, streams)
+             << setw(18) << runThreads(hashLru, streams)
+             << setw(18) << runThreads(hashLruBuffered, streams) << endl;
+
+        if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+#include "AllocCounter.h"
+#include "Workload.h"
+#include "LFUCache.h"
+#include "CompactLfuCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// LFUCache(对象池节点 + unordered_map索引) 与 CompactLfuCache(slab + 对数计数器) 对比：
+// 每条目字节数、除key/value外的固定开销、Zipf负载下的命中率与吞吐量
+// 用法: benchCompactLfu [最大容量]，默认测到1000万条目
+
+template<typename CacheType, typename... Args>
+double bytesPerEntry(int capacity, Args... args)
+{
+    long long before = Bench::liveBytes();
+    auto* cache = new CacheType(capacity, args...);
+    for (int i = 0; i < capacity; ++i) {
+        cache->put(i, i);
+    }
+    long long after = Bench::liveBytes();
+    delete cache;
+    return static_cast<double>(after - before) / capacity;
+}
+
+void printFootprint(const string& name, double bytes)
+{
+    cout << left << setw(20) << name << fixed << setprecision(1)
+         << " 每条目字节数: " << setw(8) << bytes
+         << " 额外开销: " << bytes - sizeof(int) * 2 << endl;
+}
+
+template<typename CacheType, typename... Args>
+void runZipf(const string& name, int capacity, const vector<int>& keys, Args... args)
+{
+    CacheType cache(capacity, args...);
+    auto start = chrono::steady_clock::now();
+    long long hits = 0;
+    int value = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (cache.get(keys[i], value)) {
+            ++hits;
+        } else {
+            cache.put(keys[i], keys[i]);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << left << setw(20) << name << fixed << setprecision(2)
+         << " 命中率: " << setw(7) << 100.0 * hits / keys.size() << "%"
+         << " 吞吐量: " << setprecision(0) << keys.size() / seconds << " ops/sec" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    int maxCapacity = argc > 1 ? atoi(argv[1]) : 10000000;
+
+    cout << "=== 内存占用 (key/value均为int，额外开销 = 每条目字节数 - 8) ===" << endl;
+    for (int capacity = 1000; capacity <= maxCapacity; capacity *= 10) {
+        cout << "\n--- 容量: " << capacity << " ---" << endl;
+        printFootprint("LFUCache", bytesPerEntry<LFUCache<int, int>>(capacity));
+        printFootprint("CompactLfu(8位)", bytesPerEntry<CompactLfuCache<int, int>>(capacity, 8));
+        printFootprint("CompactLfu(4位)", bytesPerEntry<CompactLfuCache<int, int>>(capacity, 4));
+    }
+
+    // 对数计数器只近似访问次数，用Zipf负载确认命中率没有明显损失
+    const int capacity = 10000;
+    const int operations = 2000000;
+    mt19937 gen(42);
+    Bench::ZipfGenerator zipf(capacity * 10, 0.99);
+    vector<int> keys(operations);
+    for (int& key : keys) key = static_cast<int>(zipf(gen));
+
+    cout << "\n=== Zipf(0.99) 负载，容量 " << capacity << "，key空间 " << capacity * 10 << " ===" << endl;
+    runZipf<LFUCache<int, int>>("LFUCache", capacity, keys);
+    runZipf<CompactLfuCache<int, int>>("CompactLfu(8位)", capacity, keys, 8);
+    runZipf<CompactLfuCache<int, int>>("CompactLfu(4位)", capacity, keys, 4);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+#include "AllocCounter.h"
+#include "LFUCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// LFUCache的每条目内存占用、稳态吞吐量与堆分配次数
+// 命中只在频次桶之间挪动结点，不应有任何堆分配；未命中的插入只剩索引节点的一次分配
+
+double bytesPerEntry(int capacity)
+{
+    long long before = Bench::liveBytes();
+    auto* cache = new LFUCache<int, int>(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        cache->put(i, i);
+    }
+    long long after = Bench::liveBytes();
+    delete cache;
+    return static_cast<double>(after - before) / capacity;
+}
+
+void runThroughput(const string& name, int capacity, const vector<int>& keys, const vector<bool>& isPut)
+{
+    LFUCache<int, int> cache(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        cache.put(i, i);
+    }
+
+    long long allocsBefore = Bench::allocCount();
+    auto start = chrono::steady_clock::now();
+    int hits = 0;
+    int value = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (isPut[i]) {
+            cache.put(keys[i], static_cast<int>(i));
+        } else if (cache.get(keys[i], value)) {
+            ++hits;
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    long long allocs = Bench::allocCount() - allocsBefore;
+
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << left << setw(14) << name
+         << " 吞吐量: " << fixed << setprecision(0) << setw(12) << keys.size() / seconds << " ops/sec"
+         << "  命中: " << setw(8) << hits
+         << "  堆分配次数: " << allocs << endl;
+}
+
+int main() {
+    const int capacities[] = {1000, 100000, 1000000};
+    const int operations = 2000000;
+
+    cout << "=== LFUCache ===" << endl;
+    for (int capacity : capacities) {
+        cout << "\n--- 容量: " << capacity << " ---" << endl;
+        cout << fixed << setprecision(1) << "每条目字节数: " << bytesPerEntry(capacity) << endl;
+
+        // 预先生成key序列，避免把随机数生成算进计时区间
+        mt19937 gen(42);
+        uniform_int_distribution<> opDis(0, 99);
+        vector<int> keys(operations);
+        vector<bool> isPut(operations);
+
+        // 全部命中：只有get，key都在缓存中
+        uniform_int_distribution<> hitDis(0, capacity - 1);
+        for (int i = 0; i < operations; ++i) {
+            keys[i] = hitDis(gen);
+            isPut[i] = false;
+        }
+        runThroughput("全部命中", capacity, keys, isPut);
+
+        // 混合：key空间为容量的两倍，20%写入
+        uniform_int_distribution<> keyDis(0, capacity * 2 - 1);
+        for (int i = 0; i < operations; ++i) {
+            keys[i] = keyDis(gen);
+            isPut[i] = opDis(gen) < 20;
+        }
+        runThroughput("混合读写", capacity, keys, isPut);
+    }
+    return 0;
+}
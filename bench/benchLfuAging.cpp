@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+
+#include "LFUCache.h"
+#include "Workload.h"
+#include "LatencyHistogram.h"
+
+using namespace Cache;
+using namespace std;
+
+// LFU频次老化的尾延迟：Eager老化在平均访问频次超限的那一次操作里改写几乎所有结点，
+// Lazy老化只累加衰减量；逐次记录get/put的耗时，比较p50/p90/p99/p99.9/最大值
+// 用法: benchLfuAging [容量]
+
+const int kMaxAverageNum = 2; // 取得很小，让老化在测试期间多次发生
+const int kOperations = 4000000;
+const int kWritePercent = 10;
+
+void run(const string& name, LfuAging aging, int capacity, const vector<int>& keys, const vector<bool>& isPut)
+{
+    LFUCache<int, int> cache(capacity, kMaxAverageNum, aging);
+    for (int i = 0; i < capacity; ++i) {
+        cache.put(i, i);
+    }
+
+    Bench::OpLatency latency;
+    int value = 0;
+    auto begin = chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint64_t start = Bench::TickClock::now();
+        if (isPut[i]) {
+            cache.put(keys[i], static_cast<int>(i));
+            latency.put.recordSince(start);
+        } else {
+            cache.get(keys[i], value);
+            latency.get.recordSince(start);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    cout << "\n" << name << " 吞吐量: " << fixed << setprecision(0) << keys.size() / seconds << " ops/sec" << endl;
+    Bench::printLatencyHeader(cout);
+    Bench::printLatencyRows(cout, name, latency);
+}
+
+int main(int argc, char* argv[]) {
+    int capacity = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (capacity <= 0) capacity = 1000000;
+
+    // 预先生成key序列，key空间为容量的两倍，Zipf分布
+    mt19937_64 gen(42);
+    Bench::ZipfGenerator zipf(static_cast<uint64_t>(capacity) * 2);
+    uniform_int_distribution<> opDis(0, 99);
+    vector<int> keys(kOperations);
+    vector<bool> isPut(kOperations);
+    for (int i = 0; i < kOperations; ++i) {
+        keys[i] = static_cast<int>(zipf(gen));
+        isPut[i] = opDis(gen) < kWritePercent;
+    }
+
+    cout << "=== LFU频次老化尾延迟 (容量: " << capacity << ", maxAverageNum: " << kMaxAverageNum << ") ===" << endl;
+    run("Eager", LfuAging::Eager, capacity, keys, isPut);
+    run("Lazy", LfuAging::Lazy, capacity, keys, isPut);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <memory>
+#include <unordered_map>
+
+#include "AllocCounter.h"
+#include "LRUCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 融合后的KLruKCache与旧的组合实现对比：吞吐量、命中率和堆内存
+// 负载与testAllCachePolicy的testHotDataAccess相同，另加一组冷数据范围很大的负载观察内存是否有界
+// 注意旧实现只重写了get(key)，这里走的get(key, value)不计入历史，它的历史只记录写入
+
+// 旧实现：主缓存、历史计数各是一个LRUCache，历史value放在无界的unordered_map里
+template<typename Key, typename Value>
+class ComposedLruKCache : public LRUCache<Key, Value>
+{
+public:
+    ComposedLruKCache(int capacity, int historyCapacity, int k)
+        : LRUCache<Key, Value>(capacity),
+          k_(k > 0 ? static_cast<size_t>(k) : 1),
+          historyList_(std::make_unique<LRUCache<Key, size_t>>(historyCapacity)) {}
+
+    Value get(const Key& key) override
+    {
+        Value value{};
+        bool inMain = LRUCache<Key, Value>::get(key, value);
+
+        size_t count = historyList_->get(key);
+        ++count;
+        historyList_->put(key, count);
+
+        if (inMain) return value;
+
+        if (count >= k_) {
+            auto it = historyValueMap_.find(key);
+            if (it != historyValueMap_.end()) {
+                Value storedValue = std::move(it->second);
+                historyList_->remove(key);
+                historyValueMap_.erase(it);
+                LRUCache<Key, Value>::put(key, storedValue);
+                return storedValue;
+            }
+        }
+        return value;
+    }
+
+    void put(const Key& key, const Value& value) override
+    {
+        putImpl(key, value);
+    }
+
+    void put(const Key& key, Value&& value) override
+    {
+        putImpl(key, std::move(value));
+    }
+
+    using LRUCache<Key, Value>::get;
+
+private:
+    template<typename V>
+    void putImpl(const Key& key, V&& value)
+    {
+        if (LRUCache<Key, Value>::visit(key, [](const Value&) {})) {
+            LRUCache<Key, Value>::put(key, std::forward<V>(value));
+            return;
+        }
+
+        size_t count = historyList_->get(key);
+        ++count;
+        historyList_->put(key, count);
+
+        if (count >= k_) {
+            historyList_->remove(key);
+            historyValueMap_.erase(key);
+            LRUCache<Key, Value>::put(key, std::forward<V>(value));
+        } else {
+            historyValueMap_[key] = std::forward<V>(value);
+        }
+    }
+
+    size_t k_;
+    std::unique_ptr<LRUCache<Key, size_t>> historyList_;
+    std::unordered_map<Key, Value> historyValueMap_;
+};
+
+struct Result
+{
+    double opsPerSec;
+    double hitRate;
+    long long bytes;
+};
+
+// 与testHotDataAccess相同：20%写，60%热点/20%中等/20%冷数据
+template<typename CacheType>
+Result run(int capacity, int hotKeys, int midKeys, int coldKeys, int operations)
+{
+    long long before = Bench::liveBytes();
+    auto* cache = new CacheType(capacity, hotKeys + midKeys + coldKeys, 2);
+    CachePolicy<int, string>& policy = *cache;
+    for (int key = 0; key < hotKeys; ++key) {
+        policy.put(key, "value" + to_string(key));
+    }
+
+    mt19937 gen(12345);
+    int hits = 0, gets = 0;
+    auto start = chrono::steady_clock::now();
+    for (int op = 0; op < operations; ++op) {
+        bool isPut = (gen() % 100 < 20);
+        int key;
+        int r = gen() % 100;
+        if (r < 60) {
+            key = gen() % hotKeys;
+        } else if (r < 80) {
+            key = hotKeys + (gen() % midKeys);
+        } else {
+            key = hotKeys + midKeys + (gen() % coldKeys);
+        }
+
+        if (isPut) {
+            policy.put(key, "value" + to_string(key) + "_v" + to_string(op % 100));
+        } else {
+            string result;
+            ++gets;
+            if (policy.get(key, result)) ++hits;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    Result result{operations / seconds, 100.0 * hits / gets, Bench::liveBytes() - before};
+    delete cache;
+    return result;
+}
+
+void report(const string& name, const Result& r)
+{
+    cout << left << setw(22) << name << fixed
+         << "吞吐量: " << setprecision(0) << setw(12) << r.opsPerSec << " ops/sec"
+         << "  命中率: " << setprecision(2) << setw(7) << r.hitRate << "%"
+         << "  堆内存: " << r.bytes / 1024 << " KB" << endl;
+}
+
+int main() {
+    const int operations = 500000;
+
+    cout << "=== 热点数据访问负载 (容量20, 热点20/中等100/冷1000) ===" << endl;
+    report("ComposedLruK(旧)", run<ComposedLruKCache<int, string>>(20, 20, 100, 1000, operations));
+    report("KLruKCache(融合)", run<KLruKCache<int, string>>(20, 20, 100, 1000, operations));
+
+    // 历史容量仍按全部key数给出，但冷key远多于实际能记住的，旧实现的value表只增不减
+    cout << "\n=== 大冷数据范围 (容量20, 历史容量同key总数, 冷key 200000) ===" << endl;
+    report("ComposedLruK(旧)", run<ComposedLruKCache<int, string>>(20, 20, 100, 200000, operations));
+    report("KLruKCache(融合)", run<KLruKCache<int, string>>(20, 20, 100, 200000, operations));
+    return 0;
+}
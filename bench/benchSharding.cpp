@@ -0,0 +1,118 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "Workload.h"
+
+using namespace Cache;
+using namespace std;
+
+// 分片均衡性测试：顺序、步长、Zipf三种整数key模式下，
+// 对比旧的 std::hash % sliceNum 与新的混合哈希+掩码，统计各分片的访问量和条目数
+
+const int kSlices = 16;
+const int kCapacity = 64000;
+const int kOperations = 1000000;
+
+struct Workload
+{
+    string name;
+    vector<int> keys;
+};
+
+vector<Workload> makeWorkloads()
+{
+    vector<Workload> workloads(3);
+    mt19937 gen(7);
+
+    workloads[0].name = "顺序";
+    workloads[1].name = "步长16";
+    workloads[2].name = "Zipf";
+    Bench::ZipfGenerator zipf(1000000);
+    for (int i = 0; i < kOperations; ++i) {
+        workloads[0].keys.push_back(i % 200000);
+        workloads[1].keys.push_back((i % 200000) * kSlices); // 步长恰好等于分片数
+        workloads[2].keys.push_back(static_cast<int>(zipf(gen)));
+    }
+    return workloads;
+}
+
+// 打印分片负载：最大分片占平均值的倍数(1.0为完全均衡)与变异系数
+void printBalance(const string& label, const vector<size_t>& load)
+{
+    double sum = 0;
+    for (size_t v : load) sum += v;
+    double mean = sum / load.size();
+    double var = 0;
+    for (size_t v : load) var += (v - mean) * (v - mean);
+    double cv = mean > 0 ? sqrt(var / load.size()) / mean : 0;
+    size_t maxLoad = *max_element(load.begin(), load.end());
+    size_t idle = count(load.begin(), load.end(), 0);
+
+    cout << "  " << left << setw(28) << label << fixed << setprecision(2)
+         << "最大/平均: " << setw(8) << (mean > 0 ? maxLoad / mean : 0)
+         << "变异系数: " << setw(8) << cv
+         << "空闲分片: " << idle << endl;
+}
+
+template<typename CacheType>
+double runThreads(CacheType& cache, const vector<int>& keys, int threads)
+{
+    atomic<bool> go{false};
+    vector<thread> workers;
+    size_t perThread = keys.size() / threads;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            int value;
+            for (size_t i = t * perThread; i < (t + 1) * perThread; ++i) {
+                if (!cache.get(keys[i], value)) cache.put(keys[i], keys[i]);
+            }
+        });
+    }
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& w : workers) w.join();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return perThread * threads / seconds;
+}
+
+int main() {
+    int threads = max(2u, thread::hardware_concurrency());
+    vector<Workload> workloads = makeWorkloads();
+
+    cout << "=== 分片负载均衡测试 (分片数: " << kSlices << ", 总容量: " << kCapacity << ") ===" << endl;
+    for (const Workload& w : workloads) {
+        cout << "\n--- " << w.name << " ---" << endl;
+
+        HashLruCaches<int, int> lru(kCapacity, kSlices);
+        KHashLfuCache<int, int> lfu(kCapacity, kSlices, 1000000); // 调大老化阈值，避免老化遍历主导耗时
+
+        // 访问量分布即锁竞争分布：访问量越集中，热点分片的锁竞争越激烈
+        vector<size_t> oldAccess(kSlices, 0), newAccess(kSlices, 0);
+        for (int key : w.keys) {
+            oldAccess[std::hash<int>{}(key) % kSlices]++;
+            newAccess[lru.sliceIndex(key)]++;
+        }
+        printBalance("访问量 旧(std::hash % n)", oldAccess);
+        printBalance("访问量 新(混合哈希 & mask)", newAccess);
+
+        double lruOps = runThreads(lru, w.keys, threads);
+        double lfuOps = runThreads(lfu, w.keys, threads);
+        printBalance("HashLruCaches 条目数", lru.sliceSizes());
+        printBalance("KHashLfuCache 条目数", lfu.sliceSizes());
+        cout << "  " << threads << "线程吞吐量: HashLruCaches " << setprecision(0) << lruOps
+             << " ops/sec, KHashLfuCache " << lfuOps << " ops/sec" << endl;
+    }
+    return 0;
+}
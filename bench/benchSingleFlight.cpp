@@ -0,0 +1,164 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <iomanip>
+#include <algorithm>
+
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "ArcCache/ArcCache.h"
+#include "LatencyHistogram.h"
+
+using namespace Cache;
+using namespace std;
+
+// 惊群(thundering herd)测试：每一轮所有线程同时读取同一个刚失效(尚未缓存)的热点key，
+// 对比不合并的读取(未命中后各自查后端再put)与getOrLoad(同一个key只加载一次)的后端调用次数和读取延迟分布
+// 后端用连接池模拟：同时最多“后端连接数”个请求，每个请求耗时固定，多出的请求排队，
+// 所以未合并时后端调用越多、排在后面的读取越慢，尾延迟随线程数线性增长
+// 用法: benchSingleFlight [线程数] [轮数] [后端延迟(微秒)] [后端连接数]，默认64线程、50轮、5000微秒、8个连接
+
+const int kCapacity = 1024;
+
+// 慢后端：连接数有限，每次调用占用一个连接latency的时间
+class SlowBackend
+{
+public:
+    SlowBackend(chrono::microseconds latency, int connections)
+        : latency_(latency), free_(connections) {}
+
+    int load(int key)
+    {
+        ++calls_;
+        {
+            unique_lock<mutex> lock(mutex_);
+            available_.wait(lock, [this]() { return free_ > 0; });
+            --free_;
+        }
+        this_thread::sleep_for(latency_);
+        {
+            lock_guard<mutex> lock(mutex_);
+            ++free_;
+        }
+        available_.notify_one();
+        return key * 2;
+    }
+
+    uint64_t calls() const { return calls_; }
+
+private:
+    chrono::microseconds latency_;
+    mutex                mutex_;
+    condition_variable   available_;
+    int                  free_;
+    atomic<uint64_t>     calls_{0};
+};
+
+struct HerdResult
+{
+    uint64_t backendCalls = 0;
+    Bench::LatencyHistogram latency;
+    bool ok = true;
+};
+
+// 每轮换一个新key，所有线程在栅栏处对齐后同时读取；read(key)返回读到的值
+template<typename Read>
+HerdResult runHerd(int threads, int rounds, Read&& read)
+{
+    HerdResult result;
+    vector<Bench::LatencyHistogram> perThread(threads);
+    atomic<int> arrived{0};
+    atomic<int> round{-1};
+    atomic<bool> ok{true};
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (int r = 0; r < rounds; ++r) {
+                ++arrived;
+                while (round.load(memory_order_acquire) < r) this_thread::yield();
+                int key = r + 1;
+                uint64_t start = Bench::TickClock::now();
+                int value = read(key);
+                perThread[t].recordSince(start);
+                if (value != key * 2) ok = false;
+            }
+        });
+    }
+    for (int r = 0; r < rounds; ++r) {
+        while (arrived.load() < threads * (r + 1)) this_thread::yield();
+        round.store(r, memory_order_release);
+    }
+    for (auto& w : workers) w.join();
+    for (const Bench::LatencyHistogram& h : perThread) result.latency += h;
+    result.ok = ok;
+    return result;
+}
+
+// 未合并：每个未命中的线程各自查后端
+template<typename CacheType>
+HerdResult naive(CacheType& cache, SlowBackend& backend, int threads, int rounds)
+{
+    HerdResult result = runHerd(threads, rounds, [&](int key) {
+        int value;
+        if (cache.get(key, value)) return value;
+        value = backend.load(key);
+        cache.put(key, value);
+        return value;
+    });
+    result.backendCalls = backend.calls();
+    return result;
+}
+
+template<typename CacheType>
+HerdResult coalesced(CacheType& cache, SlowBackend& backend, int threads, int rounds)
+{
+    HerdResult result = runHerd(threads, rounds, [&](int key) {
+        return cache.getOrLoad(key, [&backend](int k) { return backend.load(k); });
+    });
+    result.backendCalls = backend.calls();
+    return result;
+}
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? atoi(argv[1]) : 64;
+    int rounds = argc > 2 ? atoi(argv[2]) : 50;
+    chrono::microseconds latency(argc > 3 ? atoi(argv[3]) : 5000);
+    int connections = argc > 4 ? atoi(argv[4]) : 8;
+
+    cout << "=== 惊群测试 (线程 " << threads << ", 轮数 " << rounds << ", 后端延迟 " << latency.count()
+         << "us, 后端连接数 " << connections << ", CPU核数 " << thread::hardware_concurrency() << ") ===" << endl;
+
+    vector<pair<string, HerdResult>> results;
+    auto run = [&](const string& name, auto&& fn) {
+        SlowBackend backend(latency, connections);
+        results.emplace_back(name, fn(backend));
+    };
+    run("LRU-naive", [&](SlowBackend& b) { LRUCache<int, int> c(kCapacity); return naive(c, b, threads, rounds); });
+    run("LRU", [&](SlowBackend& b) { LRUCache<int, int> c(kCapacity); return coalesced(c, b, threads, rounds); });
+    run("HashLru-naive", [&](SlowBackend& b) { HashLruCaches<int, int> c(kCapacity, 16); return naive(c, b, threads, rounds); });
+    run("HashLru", [&](SlowBackend& b) { HashLruCaches<int, int> c(kCapacity, 16); return coalesced(c, b, threads, rounds); });
+    run("LFU", [&](SlowBackend& b) { LFUCache<int, int> c(kCapacity); return coalesced(c, b, threads, rounds); });
+    run("KHashLfu", [&](SlowBackend& b) { KHashLfuCache<int, int> c(kCapacity, 16); return coalesced(c, b, threads, rounds); });
+    run("ARC", [&](SlowBackend& b) { ArcCache<int, int> c(kCapacity); return coalesced(c, b, threads, rounds); });
+    run("HashArc", [&](SlowBackend& b) { HashArcCache<int, int> c(kCapacity, 16); return coalesced(c, b, threads, rounds); });
+
+    cout << left << setw(16) << "policy" << right << setw(14) << "后端调用" << setw(16) << "每轮调用" << endl;
+    bool ok = true;
+    for (const auto& entry : results) {
+        cout << left << setw(16) << entry.first << right << setw(10) << entry.second.backendCalls
+             << setw(14) << fixed << setprecision(2) << static_cast<double>(entry.second.backendCalls) / rounds << endl;
+        ok = ok && entry.second.ok;
+    }
+
+    cout << "\n读取延迟 (-naive: 未命中后各自查后端，其余为getOrLoad)" << endl;
+    Bench::printLatencyHeader(cout);
+    for (const auto& entry : results) Bench::printLatencyRow(cout, entry.first, "get", entry.second.latency);
+
+    cout << "\n读取结果校验: " << (ok ? "通过" : "失败") << endl;
+    return ok ? 0 : 1;
+}
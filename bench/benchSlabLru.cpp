@@ -0,0 +1,86 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+
+#include "AllocCounter.h"
+#include "LRUCache.h"
+#include "SlabLruCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// LRUCache(std::list + unordered_map) 与 SlabLruCache(预分配slab) 对比：
+// 每条目内存占用、稳态分配次数以及吞吐量
+
+template<typename CacheType>
+double bytesPerEntry(int capacity)
+{
+    long long before = Bench::liveBytes();
+    auto* cache = new CacheType(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        cache->put(i, i);
+    }
+    long long after = Bench::liveBytes();
+    delete cache;
+    return static_cast<double>(after - before) / capacity;
+}
+
+template<typename CacheType>
+void runThroughput(const string& name, int capacity, const vector<int>& keys, const vector<bool>& isPut)
+{
+    CacheType cache(capacity);
+    for (int i = 0; i < capacity; ++i) {
+        cache.put(i, i);
+    }
+
+    long long allocsBefore = Bench::allocCount();
+    auto start = chrono::steady_clock::now();
+    int hits = 0;
+    int value = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        if (isPut[i]) {
+            cache.put(keys[i], static_cast<int>(i));
+        } else if (cache.get(keys[i], value)) {
+            ++hits;
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    long long allocs = Bench::allocCount() - allocsBefore;
+
+    double seconds = chrono::duration<double>(end - start).count();
+    cout << left << setw(14) << name
+         << " 吞吐量: " << fixed << setprecision(0) << setw(12) << keys.size() / seconds << " ops/sec"
+         << "  命中: " << setw(8) << hits
+         << "  堆分配次数: " << allocs << endl;
+}
+
+int main() {
+    const int capacities[] = {1000, 100000, 1000000};
+    const int operations = 2000000;
+
+    cout << "=== SlabLruCache vs LRUCache ===" << endl;
+    for (int capacity : capacities) {
+        cout << "\n--- 容量: " << capacity << " ---" << endl;
+        cout << fixed << setprecision(1)
+             << "LRUCache     每条目字节数: " << bytesPerEntry<LRUCache<int, int>>(capacity) << endl
+             << "SlabLruCache 每条目字节数: " << bytesPerEntry<SlabLruCache<int, int>>(capacity) << endl;
+
+        // 预先生成key序列，避免把随机数生成算进计时区间
+        mt19937 gen(42);
+        uniform_int_distribution<> keyDis(0, capacity * 2 - 1);
+        uniform_int_distribution<> opDis(0, 99);
+        vector<int> keys(operations);
+        vector<bool> isPut(operations);
+        for (int i = 0; i < operations; ++i) {
+            keys[i] = keyDis(gen);
+            isPut[i] = opDis(gen) < 20;
+        }
+
+        runThroughput<LRUCache<int, int>>("LRUCache", capacity, keys, isPut);
+        runThroughput<SlabLruCache<int, int>>("SlabLruCache", capacity, keys, isPut);
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <cmath>
+
+#include "AllocCounter.h"
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "ArcCache/ArcCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 按字节限制容量：value大小在40B~256KB之间按对数均匀分布，
+// 对比缓存记账的总权重与实际堆内存，检查每条目开销的估算是否贴近真实占用
+
+const size_t kBudget = 32 << 20;
+const int kKeySpace = 20000;
+const int kOperations = 200000;
+
+// 预先生成每个key的value大小
+vector<size_t> makeSizes()
+{
+    mt19937 gen(3);
+    uniform_real_distribution<double> dis(log(40.0), log(256.0 * 1024));
+    vector<size_t> sizes(kKeySpace);
+    for (size_t& size : sizes) size = static_cast<size_t>(exp(dis(gen)));
+    return sizes;
+}
+
+template<typename CacheType>
+void run(const string& name, CacheType* cache, long long before, const vector<size_t>& sizes)
+{
+    mt19937 gen(11);
+    uniform_int_distribution<> keyDis(0, kKeySpace - 1);
+    int hits = 0, gets = 0;
+    string value;
+    auto start = chrono::steady_clock::now();
+    for (int op = 0; op < kOperations; ++op) {
+        int key = keyDis(gen);
+        ++gets;
+        if (cache->get(key, value)) {
+            ++hits;
+        } else {
+            cache->put(key, string(sizes[key], 'v'));
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    long long heap = Bench::liveBytes() - before;
+    size_t weight = cache->weight();
+
+    cout << left << setw(10) << name << fixed << setprecision(1)
+         << "记账权重: " << setw(8) << weight / 1048576.0 << "MB"
+         << "  实际堆内存: " << setw(8) << heap / 1048576.0 << "MB"
+         << "  实际/记账: " << setprecision(2) << setw(6) << static_cast<double>(heap) / weight
+         << "  命中率: " << setprecision(2) << setw(6) << 100.0 * hits / gets << "%"
+         << "  吞吐量: " << setprecision(0) << kOperations / seconds << " ops/sec" << endl;
+    delete cache;
+}
+
+int main() {
+    vector<size_t> sizes = makeSizes();
+    auto weigher = [](const int&, const string& v) { return v.capacity() + 1; };
+
+    cout << "=== 按字节限制容量 (预算: " << (kBudget >> 20) << "MB, value大小40B~256KB) ===" << endl;
+    long long before = Bench::liveBytes();
+    run("LRU", new LRUCache<int, string>(kBudget, weigher), before, sizes);
+    before = Bench::liveBytes();
+    run("LFU", new LFUCache<int, string>(kBudget, weigher), before, sizes);
+    // ARC两个部分各自以预算为上限，且幽灵缓存的节点仍持有value，整体最多约为预算的4倍
+    before = Bench::liveBytes();
+    run("ARC", new ArcCache<int, string>(kBudget, weigher), before, sizes);
+    before = Bench::liveBytes();
+    run("HashLRU", new HashLruCaches<int, string>(kBudget, 8, weigher), before, sizes);
+    before = Bench::liveBytes();
+    run("HashLFU", new KHashLfuCache<int, string>(kBudget, 8, weigher, 1000000), before, sizes);
+    return 0;
+}
@@ -0,0 +1,784 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <array>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "ArcCache/ArcCache.h"
+#include "Workload.h"
+#include "LatencyHistogram.h"
+
+using namespace Cache;
+using namespace std;
+
+// 微基准测试套件(cache_bench)：对各策略按 策略 x 读写比例 x 线程数 扫描吞吐量
+// - key流在计时前按线程预先生成(Zipf或均匀分布)，计时区间内只有缓存操作
+// - 每个组合新建一个缓存，先按key编号顺序填满，再用同一线程数跑一轮预热，然后重复计时reps轮
+// - 线程按编号绑定到CPU(Linux)，报告各轮吞吐量的均值、标准差与95%置信区间(t分布)
+// - --latency时逐次记录get/put延迟，额外给出p50/p99/p99.9
+// - 输出为表格、CSV或JSON，便于在版本之间比对
+// --mode capacity为容量扫描：单线程下按容量(默认1K~50M)逐个测量，key空间默认取容量的4倍，报告
+//   每次操作的纳秒数、每个条目占用的堆字节数(glibc的mallinfo2，填满前后之差)，以及
+//   perf_event_open计得的每次操作末级缓存未命中数和指令数(无权限或不支持时显示n/a)；
+//   工作集能否留在CPU缓存里主要取决于key分布，--dist uniform给出最坏情况
+// 用法: cache_bench [--mode threads|capacity] [--policies lru,lruk,hashlru,lfu,khashlfu,arc,hasharc]
+//                   [--threads 1,2,4] [--reads 100,90,50] [--capacity N] [--capacities 1K,1M,50M]
+//                   [--keys N] [--dist zipf|uniform] [--theta 0.99] [--ops N] [--warmup N] [--reps N]
+//                   [--slices N] [--seed N] [--no-pin] [--latency] [--format table|csv|json] [--out 文件]
+
+using Key = uint64_t;
+using Value = uint64_t;
+
+struct Config
+{
+    string         mode = "threads";          // threads: 线程扫描；capacity: 容量扫描
+    vector<string> policies = {"lru", "lruk", "hashlru", "lfu", "khashlfu", "arc"};
+    vector<int>    threads;                   // 为空时取1,2,4...直到CPU核数
+    vector<int>    readPercents = {100, 90, 50};
+    size_t         capacity = 100000;
+    vector<size_t> capacities = {1000, 10000, 100000, 1000000, 10000000, 50000000}; // 容量扫描的各个容量
+    size_t         keySpace = 0;              // 为空时取容量的4倍
+    string         dist = "zipf";
+    double         theta = 0.99;
+    size_t         ops = 500000;              // 每线程每轮的操作数
+    size_t         warmup = 0;                // 每线程的预热操作数，为空时取ops/5
+    int            reps = 5;
+    int            slices = 16;               // 分片缓存的分片数
+    uint64_t       seed = 42;
+    bool           pin = true;
+    bool           latency = false;
+    string         format = "table";
+    string         out;
+};
+
+struct Row
+{
+    string  policy;
+    int     threads = 0;
+    int     readPercent = 0;
+    vector<double> mops;                       // 每轮的吞吐量(百万次操作/秒)
+    double  mean = 0;
+    double  stddev = 0;
+    double  ci95 = 0;                          // 95%置信区间的半宽
+    double  hitRate = 0;
+    Bench::OpLatency latency;
+};
+
+// 一轮计时的结果
+struct Pass
+{
+    double   seconds = 0;
+    uint64_t gets = 0;
+    uint64_t hits = 0;
+};
+
+// ---------------- 参数 ----------------
+
+// 解析可带K/M/G后缀(按1000进位)的数量
+size_t parseCount(const string& text)
+{
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end && (*end == 'K' || *end == 'k')) value *= 1e3;
+    else if (end && (*end == 'M' || *end == 'm')) value *= 1e6;
+    else if (end && (*end == 'G' || *end == 'g')) value *= 1e9;
+    return value > 0 ? static_cast<size_t>(value) : 0;
+}
+
+template<typename T>
+vector<T> parseList(const string& text)
+{
+    vector<T> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        stringstream is(item);
+        T value;
+        is >> value;
+        items.push_back(value);
+    }
+    return items;
+}
+
+bool parseArgs(int argc, char* argv[], Config& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto next = [&]() -> string {
+            if (i + 1 >= argc) {
+                cerr << "缺少参数值: " << arg << endl;
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--mode") cfg.mode = next();
+        else if (arg == "--capacities") {
+            cfg.capacities.clear();
+            for (const string& item : parseList<string>(next())) cfg.capacities.push_back(parseCount(item));
+        }
+        else if (arg == "--policies") cfg.policies = parseList<string>(next());
+        else if (arg == "--threads") cfg.threads = parseList<int>(next());
+        else if (arg == "--reads") cfg.readPercents = parseList<int>(next());
+        else if (arg == "--capacity") cfg.capacity = parseCount(next());
+        else if (arg == "--keys") cfg.keySpace = parseCount(next());
+        else if (arg == "--dist") cfg.dist = next();
+        else if (arg == "--theta") cfg.theta = atof(next().c_str());
+        else if (arg == "--ops") cfg.ops = parseCount(next());
+        else if (arg == "--warmup") cfg.warmup = parseCount(next());
+        else if (arg == "--reps") cfg.reps = atoi(next().c_str());
+        else if (arg == "--slices") cfg.slices = atoi(next().c_str());
+        else if (arg == "--seed") cfg.seed = strtoull(next().c_str(), nullptr, 10);
+        else if (arg == "--no-pin") cfg.pin = false;
+        else if (arg == "--latency") cfg.latency = true;
+        else if (arg == "--format") cfg.format = next();
+        else if (arg == "--out") cfg.out = next();
+        else {
+            cerr << "未知参数: " << arg << endl;
+            return false;
+        }
+    }
+
+    if (cfg.threads.empty()) {
+        int cores = max(1u, thread::hardware_concurrency());
+        for (int t = 1; t < cores; t *= 2) cfg.threads.push_back(t);
+        cfg.threads.push_back(cores);
+    }
+    // 容量扫描时key空间按各个容量分别确定
+    if (cfg.keySpace == 0 && cfg.mode == "threads") cfg.keySpace = cfg.capacity * 4;
+    if (cfg.warmup == 0) cfg.warmup = cfg.ops / 5;
+    if (cfg.reps < 1) cfg.reps = 1;
+    if (cfg.mode != "threads" && cfg.mode != "capacity") {
+        cerr << "未知的模式: " << cfg.mode << endl;
+        return false;
+    }
+    bool badCapacity = cfg.mode == "threads"
+        ? cfg.capacity == 0
+        : cfg.capacities.empty() || count(cfg.capacities.begin(), cfg.capacities.end(), 0);
+    if (badCapacity || cfg.ops == 0) {
+        cerr << "capacity/ops/keys必须大于0" << endl;
+        return false;
+    }
+    if (cfg.dist != "zipf" && cfg.dist != "uniform") {
+        cerr << "未知的分布: " << cfg.dist << endl;
+        return false;
+    }
+    if (cfg.format != "table" && cfg.format != "csv" && cfg.format != "json") {
+        cerr << "未知的输出格式: " << cfg.format << endl;
+        return false;
+    }
+    return true;
+}
+
+// ---------------- 工作负载 ----------------
+
+// 每个线程一条key流，第t条只取决于种子和t，不同线程数的组合共用前缀
+vector<vector<Key>> makeKeyStreams(const Config& cfg, int threads)
+{
+    size_t length = max(cfg.ops, cfg.warmup);
+    vector<vector<Key>> streams(threads);
+    Bench::ZipfGenerator zipf(cfg.dist == "zipf" ? cfg.keySpace : 2, cfg.theta);
+    for (int t = 0; t < threads; ++t) {
+        mt19937_64 gen(cfg.seed + t);
+        uniform_int_distribution<Key> uniform(0, cfg.keySpace - 1);
+        Bench::ZipfGenerator localZipf = zipf;
+        streams[t].resize(length);
+        for (Key& key : streams[t]) {
+            key = cfg.dist == "zipf" ? localZipf(gen) : uniform(gen);
+        }
+    }
+    return streams;
+}
+
+// 每个线程一条读写标记流，1表示写
+vector<vector<uint8_t>> makeWriteStreams(const Config& cfg, int threads, int readPercent)
+{
+    size_t length = max(cfg.ops, cfg.warmup);
+    vector<vector<uint8_t>> streams(threads);
+    for (int t = 0; t < threads; ++t) {
+        mt19937 gen(static_cast<uint32_t>(cfg.seed * 31 + t * 7 + readPercent));
+        uniform_int_distribution<> percent(0, 99);
+        streams[t].resize(length);
+        for (uint8_t& write : streams[t]) write = percent(gen) >= readPercent;
+    }
+    return streams;
+}
+
+// ---------------- 执行 ----------------
+
+void pinToCpu(thread& worker, int index)
+{
+#ifdef __linux__
+    int cores = max(1u, thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(worker.native_handle(), sizeof(set), &set);
+#else
+    (void)worker;
+    (void)index;
+#endif
+}
+
+// 所有线程就绪后同时开始，计时从放行到全部结束；kLatency时逐次记录延迟到latency
+template<bool kLatency, typename CacheType>
+Pass runPass(CacheType& cache, const Config& cfg, const vector<vector<Key>>& keys,
+             const vector<vector<uint8_t>>& writes, size_t count, Bench::OpLatency* latency)
+{
+    int threads = static_cast<int>(keys.size());
+    atomic<int> ready{0};
+    atomic<bool> go{false};
+    vector<Pass> perThread(threads);
+    vector<Bench::OpLatency> perThreadLatency(kLatency ? threads : 0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            const Key* myKeys = keys[t].data();
+            const uint8_t* myWrites = writes[t].data();
+            uint64_t gets = 0;
+            uint64_t hits = 0;
+            Value value;
+            ready.fetch_add(1, memory_order_acq_rel);
+            while (!go.load(memory_order_acquire)) this_thread::yield();
+            for (size_t i = 0; i < count; ++i) {
+                Key key = myKeys[i];
+                uint64_t start = kLatency ? Bench::TickClock::now() : 0;
+                if (myWrites[i]) {
+                    cache.put(key, key);
+                    if constexpr (kLatency) perThreadLatency[t].put.recordSince(start);
+                } else {
+                    ++gets;
+                    hits += cache.get(key, value);
+                    if constexpr (kLatency) perThreadLatency[t].get.recordSince(start);
+                }
+            }
+            perThread[t].gets = gets;
+            perThread[t].hits = hits;
+        });
+        if (cfg.pin) pinToCpu(workers.back(), t);
+    }
+    while (ready.load(memory_order_acquire) < threads) this_thread::yield();
+    auto start = chrono::steady_clock::now();
+    go.store(true, memory_order_release);
+    for (auto& w : workers) w.join();
+
+    Pass pass;
+    pass.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    for (const Pass& p : perThread) {
+        pass.gets += p.gets;
+        pass.hits += p.hits;
+    }
+    if constexpr (kLatency) {
+        for (const auto& l : perThreadLatency) *latency += l;
+    }
+    return pass;
+}
+
+// 按名称构造缓存并调用fn(cache) | 未知名称返回false
+template<typename Fn>
+bool withPolicy(const string& name, const Config& cfg, Fn&& fn)
+{
+    int capacity = static_cast<int>(cfg.capacity);
+    if (name == "lru") {
+        LRUCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else if (name == "lruk") {
+        KLruKCache<Key, Value> cache(capacity, capacity, 2);
+        fn(cache);
+    } else if (name == "hashlru") {
+        HashLruCaches<Key, Value> cache(cfg.capacity, cfg.slices);
+        fn(cache);
+    } else if (name == "lfu") {
+        LFUCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else if (name == "khashlfu") {
+        KHashLfuCache<Key, Value> cache(cfg.capacity, cfg.slices);
+        fn(cache);
+    } else if (name == "arc") {
+        ArcCache<Key, Value> cache(cfg.capacity);
+        fn(cache);
+    } else if (name == "hasharc") {
+        HashArcCache<Key, Value> cache(cfg.capacity, cfg.slices);
+        fn(cache);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// 双侧95%置信区间的t分布临界值
+double tCritical95(int degreesOfFreedom)
+{
+    static const double table[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom <= 0) return 0;
+    if (degreesOfFreedom <= 30) return table[degreesOfFreedom];
+    return 1.96;
+}
+
+// 多轮样本的均值、样本标准差与95%置信区间半宽
+struct Summary
+{
+    double mean = 0;
+    double stddev = 0;
+    double ci95 = 0;
+};
+
+Summary summarize(const vector<double>& samples)
+{
+    Summary summary;
+    size_t n = samples.size();
+    if (n == 0) return summary;
+    double sum = 0;
+    for (double v : samples) sum += v;
+    summary.mean = sum / n;
+    double var = 0;
+    for (double v : samples) var += (v - summary.mean) * (v - summary.mean);
+    summary.stddev = n > 1 ? sqrt(var / (n - 1)) : 0;
+    summary.ci95 = n > 1 ? tCritical95(static_cast<int>(n - 1)) * summary.stddev / sqrt(static_cast<double>(n)) : 0;
+    return summary;
+}
+
+Row runConfig(const string& policy, const Config& cfg, int threads, int readPercent,
+              const vector<vector<Key>>& keys)
+{
+    vector<vector<uint8_t>> writes = makeWriteStreams(cfg, threads, readPercent);
+    Row row;
+    row.policy = policy;
+    row.threads = threads;
+    row.readPercent = readPercent;
+    uint64_t gets = 0;
+    uint64_t hits = 0;
+
+    withPolicy(policy, cfg, [&](auto& cache) {
+        size_t fill = min(cfg.capacity, cfg.keySpace);
+        for (size_t key = 0; key < fill; ++key) cache.put(key, key);
+        runPass<false>(cache, cfg, keys, writes, cfg.warmup, nullptr);
+
+        for (int rep = 0; rep < cfg.reps; ++rep) {
+            Pass pass = cfg.latency
+                ? runPass<true>(cache, cfg, keys, writes, cfg.ops, &row.latency)
+                : runPass<false>(cache, cfg, keys, writes, cfg.ops, nullptr);
+            row.mops.push_back(cfg.ops * threads / pass.seconds / 1e6);
+            gets += pass.gets;
+            hits += pass.hits;
+        }
+    });
+    row.hitRate = gets ? static_cast<double>(hits) / gets : 0;
+    Summary summary = summarize(row.mops);
+    row.mean = summary.mean;
+    row.stddev = summary.stddev;
+    row.ci95 = summary.ci95;
+    return row;
+}
+
+// ---------------- 输出 ----------------
+
+void printTableHeader(ostream& out, const Config& cfg)
+{
+    out << left << setw(10) << "policy" << right << setw(8) << "threads" << setw(7) << "read%"
+        << setw(10) << "Mops" << setw(9) << "±ci95" << setw(9) << "stddev" << setw(9) << "hit%";
+    if (cfg.latency) {
+        out << setw(9) << "get50" << setw(9) << "get99" << setw(10) << "get99.9"
+            << setw(9) << "put50" << setw(9) << "put99" << setw(10) << "put99.9";
+    }
+    out << endl;
+}
+
+void printTableRow(ostream& out, const Config& cfg, const Row& row)
+{
+    out << left << setw(10) << row.policy << right << setw(8) << row.threads << setw(7) << row.readPercent
+        << fixed << setprecision(3) << setw(10) << row.mean << setw(9) << row.ci95 << setw(9) << row.stddev
+        << setprecision(2) << setw(9) << row.hitRate * 100;
+    if (cfg.latency) {
+        out << setw(9) << row.latency.get.percentile(50) << setw(9) << row.latency.get.percentile(99)
+            << setw(10) << row.latency.get.percentile(99.9)
+            << setw(9) << row.latency.put.percentile(50) << setw(9) << row.latency.put.percentile(99)
+            << setw(10) << row.latency.put.percentile(99.9);
+    }
+    out << endl;
+}
+
+void printCsv(ostream& out, const Config& cfg, const vector<Row>& rows)
+{
+    out << "policy,threads,read_percent,capacity,key_space,dist,ops_per_thread,reps,"
+           "mops_mean,mops_stddev,mops_ci95,mops_min,mops_max,hit_rate";
+    if (cfg.latency) {
+        out << ",get_p50_ns,get_p90_ns,get_p99_ns,get_p999_ns,get_max_ns"
+               ",put_p50_ns,put_p90_ns,put_p99_ns,put_p999_ns,put_max_ns";
+    }
+    out << "\n";
+    for (const Row& row : rows) {
+        out << row.policy << "," << row.threads << "," << row.readPercent << "," << cfg.capacity << ","
+            << cfg.keySpace << "," << cfg.dist << "," << cfg.ops << "," << cfg.reps << ","
+            << fixed << setprecision(4) << row.mean << "," << row.stddev << "," << row.ci95 << ","
+            << *min_element(row.mops.begin(), row.mops.end()) << ","
+            << *max_element(row.mops.begin(), row.mops.end()) << "," << row.hitRate;
+        if (cfg.latency) {
+            for (const Bench::LatencyHistogram* h : {&row.latency.get, &row.latency.put}) {
+                out << "," << h->percentile(50) << "," << h->percentile(90) << "," << h->percentile(99)
+                    << "," << h->percentile(99.9) << "," << h->max();
+            }
+        }
+        out << "\n";
+    }
+}
+
+void printJson(ostream& out, const Config& cfg, const vector<Row>& rows)
+{
+    auto histogramJson = [&out](const Bench::LatencyHistogram& h) {
+        out << "{\"count\": " << h.count() << ", \"p50_ns\": " << h.percentile(50)
+            << ", \"p90_ns\": " << h.percentile(90) << ", \"p99_ns\": " << h.percentile(99)
+            << ", \"p999_ns\": " << h.percentile(99.9) << ", \"max_ns\": " << h.max() << "}";
+    };
+
+    out << "{\n  \"config\": {\"capacity\": " << cfg.capacity << ", \"key_space\": " << cfg.keySpace
+        << ", \"dist\": \"" << cfg.dist << "\", \"theta\": " << cfg.theta
+        << ", \"ops_per_thread\": " << cfg.ops << ", \"warmup_per_thread\": " << cfg.warmup
+        << ", \"reps\": " << cfg.reps << ", \"slices\": " << cfg.slices << ", \"seed\": " << cfg.seed
+        << ", \"pinned\": " << (cfg.pin ? "true" : "false")
+        << ", \"cpus\": " << thread::hardware_concurrency() << "},\n  \"results\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const Row& row = rows[i];
+        out << (i ? ",\n" : "\n") << "    {\"policy\": \"" << row.policy << "\", \"threads\": " << row.threads
+            << ", \"read_percent\": " << row.readPercent << fixed << setprecision(4)
+            << ", \"mops_mean\": " << row.mean << ", \"mops_stddev\": " << row.stddev
+            << ", \"mops_ci95\": " << row.ci95 << ", \"hit_rate\": " << row.hitRate << ", \"mops\": [";
+        for (size_t r = 0; r < row.mops.size(); ++r) out << (r ? ", " : "") << row.mops[r];
+        out << "]";
+        if (cfg.latency) {
+            out << ", \"get\": ";
+            histogramJson(row.latency.get);
+            out << ", \"put\": ";
+            histogramJson(row.latency.put);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// ---------------- 容量扫描 ----------------
+
+// 当前已分配的堆字节数：glibc下用mallinfo2(各arena合计，含mmap分配的大块)，其它平台返回0表示不可用
+size_t allocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// 硬件计数器：末级缓存未命中与用户态指令数，只统计调用线程
+// 内核不支持、容器内无权限(perf_event_paranoid)或非Linux时对应计数器不可用，结果记为n/a
+class PerfCounters
+{
+public:
+    enum Event { LlcMisses, Instructions, kEvents };
+
+    PerfCounters()
+    {
+        fds_.fill(-1);
+#ifdef __linux__
+        const uint64_t configs[kEvents] = {PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_INSTRUCTIONS};
+        for (int e = 0; e < kEvents; ++e) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds_[e] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event e) const { return fds_[e] >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        for (int fd : fds_) {
+            if (fd < 0) continue;
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // 停止计数，values[e]传出start以来的计数，不可用的计数器为0
+    void stop(array<uint64_t, kEvents>& values)
+    {
+        values.fill(0);
+#ifdef __linux__
+        for (int e = 0; e < kEvents; ++e) {
+            if (fds_[e] < 0) continue;
+            ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fds_[e], &values[e], sizeof(uint64_t)) != sizeof(uint64_t)) values[e] = 0;
+        }
+#endif
+    }
+
+private:
+    array<int, kEvents> fds_;
+};
+
+struct CapacityRow
+{
+    string  policy;
+    size_t  capacity = 0;
+    size_t  keySpace = 0;
+    int     readPercent = 0;
+    vector<double> nsPerOp;                    // 每轮的平均每次操作耗时
+    double  mean = 0;
+    double  ci95 = 0;
+    double  bytesPerEntry = -1;                // 负数表示不可用
+    double  llcMissesPerOp = -1;
+    double  instructionsPerOp = -1;
+    double  hitRate = 0;
+};
+
+// 在调用线程里顺序执行，不建线程，计数器只需统计本线程
+template<typename CacheType>
+Pass runSerial(CacheType& cache, const vector<Key>& keys, const vector<uint8_t>& writes, size_t count)
+{
+    Pass pass;
+    Value value;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        Key key = keys[i];
+        if (writes[i]) {
+            cache.put(key, key);
+        } else {
+            ++pass.gets;
+            pass.hits += cache.get(key, value);
+        }
+    }
+    pass.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return pass;
+}
+
+CapacityRow runCapacity(const string& policy, const Config& cfg, int readPercent, const vector<Key>& keys,
+                        const vector<uint8_t>& writes, PerfCounters& perf)
+{
+    CapacityRow row;
+    row.policy = policy;
+    row.capacity = cfg.capacity;
+    row.keySpace = cfg.keySpace;
+    row.readPercent = readPercent;
+    uint64_t gets = 0;
+    uint64_t hits = 0;
+    array<uint64_t, PerfCounters::kEvents> totals{};
+
+    size_t before = allocatedBytes();
+    withPolicy(policy, cfg, [&](auto& cache) {
+        size_t fill = min(cfg.capacity, cfg.keySpace);
+        for (size_t key = 0; key < fill; ++key) cache.put(key, key);
+        size_t after = allocatedBytes();
+        if (after > 0 && fill > 0) row.bytesPerEntry = (static_cast<double>(after) - before) / fill;
+
+        runSerial(cache, keys, writes, cfg.warmup);
+        for (int rep = 0; rep < cfg.reps; ++rep) {
+            array<uint64_t, PerfCounters::kEvents> counts;
+            perf.start();
+            Pass pass = runSerial(cache, keys, writes, cfg.ops);
+            perf.stop(counts);
+            for (int e = 0; e < PerfCounters::kEvents; ++e) totals[e] += counts[e];
+            row.nsPerOp.push_back(pass.seconds * 1e9 / cfg.ops);
+            gets += pass.gets;
+            hits += pass.hits;
+        }
+    });
+
+    double ops = static_cast<double>(cfg.ops) * cfg.reps;
+    if (perf.available(PerfCounters::LlcMisses)) row.llcMissesPerOp = totals[PerfCounters::LlcMisses] / ops;
+    if (perf.available(PerfCounters::Instructions)) row.instructionsPerOp = totals[PerfCounters::Instructions] / ops;
+    row.hitRate = gets ? static_cast<double>(hits) / gets : 0;
+
+    Summary summary = summarize(row.nsPerOp);
+    row.mean = summary.mean;
+    row.ci95 = summary.ci95;
+    return row;
+}
+
+// 不可用的指标：表格中为n/a，CSV中为空，JSON中为null
+string metric(double value, int precision, const string& missing)
+{
+    if (value < 0) return missing;
+    stringstream ss;
+    ss << fixed << setprecision(precision) << value;
+    return ss.str();
+}
+
+void printCapacityHeader(ostream& out)
+{
+    out << left << setw(10) << "policy" << right << setw(11) << "capacity" << setw(7) << "read%"
+        << setw(10) << "ns/op" << setw(9) << "±ci95" << setw(9) << "B/entry" << setw(9) << "hit%"
+        << setw(12) << "LLCmiss/op" << setw(11) << "instr/op" << endl;
+}
+
+void printCapacityRow(ostream& out, const CapacityRow& row)
+{
+    out << left << setw(10) << row.policy << right << setw(11) << row.capacity << setw(7) << row.readPercent
+        << fixed << setprecision(1) << setw(10) << row.mean << setw(9) << row.ci95
+        << setw(9) << metric(row.bytesPerEntry, 1, "n/a") << setprecision(2) << setw(9) << row.hitRate * 100
+        << setw(12) << metric(row.llcMissesPerOp, 3, "n/a") << setw(11) << metric(row.instructionsPerOp, 0, "n/a")
+        << endl;
+}
+
+void printCapacityCsv(ostream& out, const Config& cfg, const vector<CapacityRow>& rows)
+{
+    out << "policy,capacity,key_space,read_percent,dist,ops,reps,ns_per_op_mean,ns_per_op_ci95,"
+           "bytes_per_entry,hit_rate,llc_misses_per_op,instructions_per_op\n";
+    for (const CapacityRow& row : rows) {
+        out << row.policy << "," << row.capacity << "," << row.keySpace << "," << row.readPercent << ","
+            << cfg.dist << "," << cfg.ops << "," << cfg.reps << "," << fixed << setprecision(3)
+            << row.mean << "," << row.ci95 << "," << metric(row.bytesPerEntry, 2, "") << ","
+            << setprecision(4) << row.hitRate << "," << metric(row.llcMissesPerOp, 4, "") << ","
+            << metric(row.instructionsPerOp, 1, "") << "\n";
+    }
+}
+
+void printCapacityJson(ostream& out, const Config& cfg, const vector<CapacityRow>& rows)
+{
+    out << "{\n  \"config\": {\"mode\": \"capacity\", \"dist\": \"" << cfg.dist << "\", \"theta\": " << cfg.theta
+        << ", \"ops\": " << cfg.ops << ", \"warmup\": " << cfg.warmup << ", \"reps\": " << cfg.reps
+        << ", \"slices\": " << cfg.slices << ", \"seed\": " << cfg.seed << "},\n  \"results\": [";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const CapacityRow& row = rows[i];
+        out << (i ? ",\n" : "\n") << "    {\"policy\": \"" << row.policy << "\", \"capacity\": " << row.capacity
+            << ", \"key_space\": " << row.keySpace << ", \"read_percent\": " << row.readPercent
+            << fixed << setprecision(3) << ", \"ns_per_op_mean\": " << row.mean
+            << ", \"ns_per_op_ci95\": " << row.ci95
+            << ", \"bytes_per_entry\": " << metric(row.bytesPerEntry, 2, "null")
+            << ", \"hit_rate\": " << setprecision(4) << row.hitRate
+            << ", \"llc_misses_per_op\": " << metric(row.llcMissesPerOp, 4, "null")
+            << ", \"instructions_per_op\": " << metric(row.instructionsPerOp, 1, "null") << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// 按容量从小到大逐个测量；每个容量的key流只生成一次，各策略共用
+void runCapacitySweep(const Config& cfg, ostream& out, ostream& progress, bool table)
+{
+    PerfCounters perf;
+    progress << "=== cache_bench 容量扫描 (分布 " << cfg.dist << ", 每个容量 " << cfg.ops << " 次操作 x "
+             << cfg.reps << " 轮, 预热 " << cfg.warmup << ", 单线程"
+             << ", 硬件计数器: " << (perf.available(PerfCounters::Instructions) ? "可用" : "不可用")
+             << ") ===" << endl;
+    if (table) printCapacityHeader(out);
+
+    vector<CapacityRow> rows;
+    for (size_t capacity : cfg.capacities) {
+        Config local = cfg;
+        local.capacity = capacity;
+        local.keySpace = cfg.keySpace ? cfg.keySpace : capacity * 4;
+        vector<Key> keys = move(makeKeyStreams(local, 1)[0]);
+        for (int readPercent : cfg.readPercents) {
+            vector<uint8_t> writes = move(makeWriteStreams(local, 1, readPercent)[0]);
+            for (const string& policy : cfg.policies) {
+                rows.push_back(runCapacity(policy, local, readPercent, keys, writes, perf));
+                if (table) printCapacityRow(out, rows.back());
+                else progress << "  " << policy << " capacity=" << capacity << " read%=" << readPercent
+                              << " done" << endl;
+            }
+        }
+    }
+
+    if (cfg.format == "csv") printCapacityCsv(out, cfg, rows);
+    else if (cfg.format == "json") printCapacityJson(out, cfg, rows);
+}
+
+// 按线程数扫描；每个线程数的key流只生成一次，各读写比例和策略共用
+void runThreadSweep(const Config& cfg, ostream& out, ostream& progress, bool table)
+{
+    progress << "=== cache_bench (容量 " << cfg.capacity << ", key空间 " << cfg.keySpace << ", 分布 " << cfg.dist
+             << ", 每线程 " << cfg.ops << " 次操作 x " << cfg.reps << " 轮, 预热 " << cfg.warmup
+             << ", CPU核数 " << thread::hardware_concurrency() << (cfg.pin ? ", 绑核" : "") << ") ===" << endl;
+    if (table) printTableHeader(out, cfg);
+
+    vector<Row> rows;
+    for (int threads : cfg.threads) {
+        if (threads < 1) continue;
+        vector<vector<Key>> keys = makeKeyStreams(cfg, threads);
+        for (int readPercent : cfg.readPercents) {
+            for (const string& policy : cfg.policies) {
+                rows.push_back(runConfig(policy, cfg, threads, readPercent, keys));
+                if (table) printTableRow(out, cfg, rows.back());
+                else progress << "  " << policy << " threads=" << threads << " read%=" << readPercent
+                              << " done" << endl;
+            }
+        }
+    }
+
+    if (cfg.format == "csv") printCsv(out, cfg, rows);
+    else if (cfg.format == "json") printJson(out, cfg, rows);
+}
+
+int main(int argc, char* argv[]) {
+    Config cfg;
+    if (!parseArgs(argc, argv, cfg)) return 2;
+    for (const string& policy : cfg.policies) {
+        if (!withPolicy(policy, cfg, [](auto&) {})) {
+            cerr << "未知的策略: " << policy << endl;
+            return 2;
+        }
+    }
+
+    ofstream file;
+    if (!cfg.out.empty()) {
+        file.open(cfg.out);
+        if (!file) {
+            cerr << "无法写入: " << cfg.out << endl;
+            return 2;
+        }
+    }
+    ostream& out = cfg.out.empty() ? cout : file;
+    bool table = cfg.format == "table";
+    // 表格边跑边输出；CSV/JSON跑完一次性写出，进度打印到stderr
+    ostream& progress = table ? out : cerr;
+
+    if (cfg.mode == "capacity") runCapacitySweep(cfg, out, progress, table);
+    else runThreadSweep(cfg, out, progress, table);
+    return 0;
+}
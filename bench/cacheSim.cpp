@@ -0,0 +1,486 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "LRUCache.h"
+#include "LFUCache.h"
+#include "SlabLruCache.h"
+#include "ClockCache.h"
+#include "TinyLfuCache.h"
+#include "ArcCache/ArcCache.h"
+#include "MissRatioCurve.h"
+#include "Trace.h"
+
+using namespace Cache;
+using namespace std;
+
+// 轨迹回放模拟器(cache_sim)：把一份访问轨迹依次喂给各个策略，报告命中率、字节命中率和回放速度
+// - 轨迹文件整体mmap，按记录流式解码，十亿条级别的轨迹也不需要读进内存
+// - 每个策略由一个线程独立回放整份轨迹(每个线程绑定一个CPU)，同时运行的线程数不超过--jobs
+// - 读请求命中计入命中率；未命中时把对象写入缓存(按需填充)；写请求直接写入缓存，不计入命中率
+// - 默认按条目数限制容量；--bytes按字节限制(对象大小取自轨迹，另加各策略每条目的固定开销估算)，
+//   只有支持weigher的策略(lru/hashlru/lfu/khashlfu/arc/arc-canonical/hasharc)可用
+// - 前--warmup条请求只回放不计数；回放速度包含轨迹解码的开销
+// - --convert把任意支持的格式转成二进制格式后退出，二进制格式解码最快
+// - --mrc额外用一个线程以SHARDS采样估计LRU的命中率曲线(--capacity的1%~400%，读计入、写只更新访问顺序)，
+//   采样的key数不超过--mrc-samples；可与lru的实际命中率对照，--mrc-points all输出全部400个点
+// 轨迹格式见bench/Trace.h；--format auto时按魔数识别二进制格式，.csv按CSV读取，其余按每行一个key读取
+// 用法: cache_sim --trace 文件 [--format auto|bin|text|keys|arc|csv] [--policies lru,arc,...]
+//                 [--capacity N | --bytes N] [--slices N] [--jobs N] [--limit N] [--warmup N]
+//                 [--size N] [--csv-key N] [--csv-size N] [--csv-op N] [--csv-header]
+//                 [--mrc] [--mrc-samples N] [--mrc-points all]
+//                 [--output table|csv|json] [--out 文件] [--convert 输出.bin]
+
+using Key = uint64_t;
+using Value = uint32_t;   // 缓存里只存对象大小
+
+const vector<string> kAllPolicies = {"lru", "lruk", "hashlru", "lfu", "khashlfu", "arc", "arc-canonical",
+                                     "hasharc", "slablru", "clock", "clockpro", "tinylfu"};
+const vector<string> kWeightedPolicies = {"lru", "hashlru", "lfu", "khashlfu", "arc", "arc-canonical", "hasharc"};
+
+struct SimConfig
+{
+    string             trace;
+    string             format = "auto";
+    Bench::TraceOptions traceOptions;
+    vector<string>     policies;              // 为空时取当前容量模式下支持的全部策略
+    size_t             capacity = 100000;     // 条目数
+    size_t             bytes = 0;             // 非0时按字节限制容量
+    int                slices = 16;
+    int                jobs = 0;              // 同时回放的策略数，0为CPU核数
+    uint64_t           limit = UINT64_MAX;    // 最多回放的请求数
+    uint64_t           warmup = 0;
+    string             output = "table";
+    string             out;
+    string             convert;
+    bool               mrc = false;
+    size_t             mrcSamples = 8192;
+    bool               mrcAllPoints = false;
+};
+
+struct SimResult
+{
+    string   policy;
+    uint64_t requests = 0;     // 计数区间内的请求数(读+写)
+    uint64_t gets = 0;
+    uint64_t hits = 0;
+    uint64_t getBytes = 0;
+    uint64_t hitBytes = 0;
+    double   seconds = 0;      // 整个回放(含预热)的耗时
+    uint64_t replayed = 0;     // 整个回放(含预热)的请求数
+    CacheStats stats;
+
+    double hitRatio() const { return gets ? static_cast<double>(hits) / gets : 0; }
+    double byteHitRatio() const { return getBytes ? static_cast<double>(hitBytes) / getBytes : 0; }
+    double opsPerSec() const { return seconds > 0 ? replayed / seconds : 0; }
+};
+
+// ---------------- 参数 ----------------
+
+vector<string> splitList(const string& text)
+{
+    vector<string> items;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// 解析可带K/M/G后缀(按1000进位)的数量
+uint64_t parseCount(const string& text)
+{
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end && (*end == 'K' || *end == 'k')) value *= 1e3;
+    else if (end && (*end == 'M' || *end == 'm')) value *= 1e6;
+    else if (end && (*end == 'G' || *end == 'g')) value *= 1e9;
+    return value > 0 ? static_cast<uint64_t>(value) : 0;
+}
+
+bool parseArgs(int argc, char* argv[], SimConfig& cfg)
+{
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto next = [&]() -> string {
+            if (i + 1 >= argc) {
+                cerr << "缺少参数值: " << arg << endl;
+                exit(2);
+            }
+            return argv[++i];
+        };
+        if (arg == "--trace") cfg.trace = next();
+        else if (arg == "--format") cfg.format = next();
+        else if (arg == "--policies") cfg.policies = splitList(next());
+        else if (arg == "--capacity") cfg.capacity = parseCount(next());
+        else if (arg == "--bytes") cfg.bytes = parseCount(next());
+        else if (arg == "--slices") cfg.slices = atoi(next().c_str());
+        else if (arg == "--jobs") cfg.jobs = atoi(next().c_str());
+        else if (arg == "--limit") cfg.limit = parseCount(next());
+        else if (arg == "--warmup") cfg.warmup = parseCount(next());
+        else if (arg == "--size") cfg.traceOptions.defaultSize = static_cast<uint32_t>(parseCount(next()));
+        else if (arg == "--csv-key") cfg.traceOptions.csvKeyColumn = atoi(next().c_str());
+        else if (arg == "--csv-size") cfg.traceOptions.csvSizeColumn = atoi(next().c_str());
+        else if (arg == "--csv-op") cfg.traceOptions.csvOpColumn = atoi(next().c_str());
+        else if (arg == "--csv-header") cfg.traceOptions.csvHeader = true;
+        else if (arg == "--output") cfg.output = next();
+        else if (arg == "--out") cfg.out = next();
+        else if (arg == "--convert") cfg.convert = next();
+        else if (arg == "--mrc") cfg.mrc = true;
+        else if (arg == "--mrc-samples") cfg.mrcSamples = parseCount(next());
+        else if (arg == "--mrc-points") cfg.mrcAllPoints = next() == "all";
+        else {
+            cerr << "未知参数: " << arg << endl;
+            return false;
+        }
+    }
+
+    if (cfg.trace.empty()) {
+        cerr << "需要--trace指定轨迹文件" << endl;
+        return false;
+    }
+    if (cfg.policies.empty()) cfg.policies = cfg.bytes ? kWeightedPolicies : kAllPolicies;
+    if (cfg.jobs <= 0) cfg.jobs = max(1u, thread::hardware_concurrency());
+    if (cfg.traceOptions.defaultSize == 0) cfg.traceOptions.defaultSize = 1;
+    if (cfg.capacity == 0 && (cfg.bytes == 0 || cfg.mrc)) {
+        cerr << "容量必须大于0" << endl;
+        return false;
+    }
+    if (cfg.output != "table" && cfg.output != "csv" && cfg.output != "json") {
+        cerr << "未知的输出格式: " << cfg.output << endl;
+        return false;
+    }
+    return true;
+}
+
+// 确定轨迹格式 | 不认识的格式名返回false
+bool resolveFormat(SimConfig& cfg, const Bench::MappedFile& file)
+{
+    string format = cfg.format;
+    if (format == "auto") {
+        bool csv = cfg.trace.size() >= 4 && cfg.trace.compare(cfg.trace.size() - 4, 4, ".csv") == 0;
+        format = file.isBinaryTrace() ? "bin" : csv ? "csv" : "keys";
+    }
+    if (format == "bin") cfg.traceOptions.format = Bench::TraceFormat::Binary;
+    else if (format == "text") cfg.traceOptions.format = Bench::TraceFormat::Text;
+    else if (format == "keys") cfg.traceOptions.format = Bench::TraceFormat::Keys;
+    else if (format == "arc") cfg.traceOptions.format = Bench::TraceFormat::Arc;
+    else if (format == "csv") cfg.traceOptions.format = Bench::TraceFormat::Csv;
+    else return false;
+    cfg.format = format;
+    return true;
+}
+
+// ---------------- 回放 ----------------
+
+// 按名称构造缓存并调用fn(cache) | 未知名称或不支持当前容量模式时返回false
+template<typename Fn>
+bool withPolicy(const string& name, const SimConfig& cfg, Fn&& fn)
+{
+    Weigher<Key, Value> weigher = [](const Key&, const Value& size) { return static_cast<size_t>(size); };
+    bool weighted = cfg.bytes > 0;
+    int capacity = static_cast<int>(cfg.capacity);
+
+    if (name == "lru") {
+        if (weighted) { LRUCache<Key, Value> cache(cfg.bytes, weigher); fn(cache); }
+        else { LRUCache<Key, Value> cache(capacity); fn(cache); }
+    } else if (name == "hashlru") {
+        if (weighted) { HashLruCaches<Key, Value> cache(cfg.bytes, cfg.slices, weigher); fn(cache); }
+        else { HashLruCaches<Key, Value> cache(cfg.capacity, cfg.slices); fn(cache); }
+    } else if (name == "lfu") {
+        if (weighted) { LFUCache<Key, Value> cache(cfg.bytes, weigher); fn(cache); }
+        else { LFUCache<Key, Value> cache(capacity); fn(cache); }
+    } else if (name == "khashlfu") {
+        if (weighted) { KHashLfuCache<Key, Value> cache(cfg.bytes, cfg.slices, weigher); fn(cache); }
+        else { KHashLfuCache<Key, Value> cache(cfg.capacity, cfg.slices); fn(cache); }
+    } else if (name == "arc" || name == "arc-canonical") {
+        ArcMode mode = name == "arc" ? ArcMode::Adaptive : ArcMode::Canonical;
+        if (weighted) { ArcCache<Key, Value> cache(cfg.bytes, weigher, 2, mode); fn(cache); }
+        else { ArcCache<Key, Value> cache(cfg.capacity, 2, mode); fn(cache); }
+    } else if (name == "hasharc") {
+        if (weighted) { HashArcCache<Key, Value> cache(cfg.bytes, cfg.slices, weigher); fn(cache); }
+        else { HashArcCache<Key, Value> cache(cfg.capacity, cfg.slices); fn(cache); }
+    } else if (weighted) {
+        return false;
+    } else if (name == "lruk") {
+        KLruKCache<Key, Value> cache(capacity, capacity, 2);
+        fn(cache);
+    } else if (name == "slablru") {
+        SlabLruCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else if (name == "clock") {
+        ClockCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else if (name == "clockpro") {
+        ClockProCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else if (name == "tinylfu") {
+        TinyLfuCache<Key, Value> cache(capacity);
+        fn(cache);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+template<typename CacheType>
+void replay(CacheType& cache, const Bench::MappedFile& file, const SimConfig& cfg, SimResult& result)
+{
+    Bench::TraceReader reader(file, cfg.traceOptions);
+    Bench::TraceRecord record;
+    Value value;
+    uint64_t n = 0;
+    auto start = chrono::steady_clock::now();
+    while (n < cfg.limit && reader.next(record)) {
+        bool counted = ++n > cfg.warmup;
+        if (record.op == Bench::TraceOp::Put) {
+            cache.put(record.key, record.size);
+            result.requests += counted;
+            continue;
+        }
+        bool hit = cache.get(record.key, value);
+        if (!hit) cache.put(record.key, record.size);
+        if (counted) {
+            ++result.requests;
+            ++result.gets;
+            result.getBytes += record.size;
+            result.hits += hit;
+            result.hitBytes += hit ? record.size : 0;
+        }
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    result.replayed = n;
+    result.stats = cache.stats();
+}
+
+// 离线估计命中率曲线：只把轨迹喂给估计器，不经过缓存
+void estimateMrc(MrcEstimator& mrc, const Bench::MappedFile& file, const SimConfig& cfg)
+{
+    Bench::TraceReader reader(file, cfg.traceOptions);
+    Bench::TraceRecord record;
+    uint64_t n = 0;
+    while (n < cfg.limit && reader.next(record)) {
+        ++n;
+        mrc.record(record.key, record.op == Bench::TraceOp::Get);
+    }
+}
+
+void pinToCpu(int index)
+{
+#ifdef __linux__
+    int cores = max(1u, thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cores, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)index;
+#endif
+}
+
+// jobs个线程从队列里依次领取策略，每个策略由一个线程回放整份轨迹；mrc非空时估计曲线也作为一项任务
+vector<SimResult> runAll(const SimConfig& cfg, const Bench::MappedFile& file, MrcEstimator* mrc, ostream& progress)
+{
+    vector<SimResult> results(cfg.policies.size());
+    size_t tasks = cfg.policies.size() + (mrc ? 1 : 0);
+    atomic<size_t> nextTask{0};
+    mutex progressMutex;
+    int jobs = min<int>(cfg.jobs, static_cast<int>(tasks));
+    vector<thread> workers;
+    for (int j = 0; j < jobs; ++j) {
+        workers.emplace_back([&, j]() {
+            pinToCpu(j);
+            for (size_t i = nextTask.fetch_add(1); i < tasks; i = nextTask.fetch_add(1)) {
+                if (i == cfg.policies.size()) {
+                    estimateMrc(*mrc, file, cfg);
+                    lock_guard<mutex> lock(progressMutex);
+                    progress << "  命中率曲线 完成: 采样率 " << mrc->samplingRate() << endl;
+                    continue;
+                }
+                SimResult& result = results[i];
+                result.policy = cfg.policies[i];
+                withPolicy(result.policy, cfg, [&](auto& cache) { replay(cache, file, cfg, result); });
+                lock_guard<mutex> lock(progressMutex);
+                progress << "  " << result.policy << " 完成: " << result.replayed << " 条请求, "
+                         << fixed << setprecision(1) << result.seconds << " s" << endl;
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+    return results;
+}
+
+// 转成二进制格式 | 返回写出的记录数
+uint64_t convertTrace(const SimConfig& cfg, const Bench::MappedFile& file)
+{
+    Bench::TraceReader reader(file, cfg.traceOptions);
+    Bench::TraceWriter writer(cfg.convert);
+    Bench::TraceRecord record;
+    uint64_t n = 0;
+    while (n < cfg.limit && reader.next(record)) {
+        writer.write(record);
+        ++n;
+    }
+    if (!writer.close()) throw runtime_error("写入失败: " + cfg.convert);
+    return n;
+}
+
+// ---------------- 输出 ----------------
+
+void printTable(ostream& out, const vector<SimResult>& results)
+{
+    out << left << setw(15) << "policy" << right << setw(14) << "requests" << setw(14) << "gets"
+        << setw(9) << "hit%" << setw(11) << "byteHit%" << setw(12) << "evictions" << setw(12) << "Mops/s" << endl;
+    for (const SimResult& r : results) {
+        out << left << setw(15) << r.policy << right << setw(14) << r.requests << setw(14) << r.gets
+            << fixed << setprecision(2) << setw(9) << r.hitRatio() * 100 << setw(11) << r.byteHitRatio() * 100
+            << setw(12) << r.stats.evictions << setprecision(3) << setw(12) << r.opsPerSec() / 1e6 << endl;
+    }
+}
+
+void printCsv(ostream& out, const SimConfig& cfg, const vector<SimResult>& results)
+{
+    out << "policy,trace,format,capacity,bytes,requests,gets,hits,hit_ratio,get_bytes,hit_bytes,"
+           "byte_hit_ratio,evictions,ops_per_sec\n";
+    for (const SimResult& r : results) {
+        out << r.policy << "," << cfg.trace << "," << cfg.format << "," << (cfg.bytes ? 0 : cfg.capacity) << ","
+            << cfg.bytes << "," << r.requests << "," << r.gets << "," << r.hits << ","
+            << fixed << setprecision(6) << r.hitRatio() << "," << r.getBytes << "," << r.hitBytes << ","
+            << r.byteHitRatio() << "," << r.stats.evictions << "," << setprecision(0) << r.opsPerSec() << "\n";
+    }
+}
+
+void printJson(ostream& out, const SimConfig& cfg, const vector<SimResult>& results, const vector<MrcPoint>& mrc)
+{
+    out << "{\n  \"config\": {\"trace\": \"" << cfg.trace << "\", \"format\": \"" << cfg.format
+        << "\", \"capacity\": " << (cfg.bytes ? 0 : cfg.capacity) << ", \"bytes\": " << cfg.bytes
+        << ", \"warmup\": " << cfg.warmup << ", \"slices\": " << cfg.slices << "},\n  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SimResult& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"policy\": \"" << r.policy << "\", \"requests\": " << r.requests
+            << ", \"gets\": " << r.gets << ", \"hits\": " << r.hits << fixed << setprecision(6)
+            << ", \"hit_ratio\": " << r.hitRatio() << ", \"get_bytes\": " << r.getBytes
+            << ", \"hit_bytes\": " << r.hitBytes << ", \"byte_hit_ratio\": " << r.byteHitRatio()
+            << ", \"evictions\": " << r.stats.evictions << setprecision(0)
+            << ", \"ops_per_sec\": " << r.opsPerSec() << "}";
+    }
+    out << "\n  ]";
+    if (!mrc.empty()) {
+        out << ",\n  \"mrc\": [";
+        for (size_t i = 0; i < mrc.size(); ++i) {
+            out << (i ? ", " : "") << "{\"capacity\": " << mrc[i].capacity << ", \"hit_ratio\": "
+                << fixed << setprecision(6) << mrc[i].hitRatio << "}";
+        }
+        out << "]";
+    }
+    out << "\n}\n";
+}
+
+// 命中率曲线上要输出的点：默认为若干个代表性的百分比，--mrc-points all时为全部
+vector<MrcPoint> selectMrcPoints(const SimConfig& cfg, const MrcEstimator& mrc)
+{
+    vector<MrcPoint> curve = mrc.curve();
+    if (cfg.mrcAllPoints) return curve;
+    vector<MrcPoint> points;
+    for (int percent : {1, 2, 5, 10, 25, 50, 75, 100, 125, 150, 200, 300, 400}) {
+        points.push_back(curve[percent - 1]);
+    }
+    return points;
+}
+
+void printMrc(ostream& out, const SimConfig& cfg, const MrcEstimator& mrc)
+{
+    out << "\n=== LRU命中率曲线估计 (SHARDS, 采样率 " << mrc.samplingRate() << ", 内存约 "
+        << mrc.memoryBytes() / 1024 << " KB) ===" << endl;
+    out << right << setw(14) << "capacity" << setw(10) << "percent" << setw(12) << "hit%" << endl;
+    for (const MrcPoint& p : selectMrcPoints(cfg, mrc)) {
+        out << setw(14) << p.capacity << setw(9) << fixed << setprecision(0) << 100.0 * p.capacity / cfg.capacity
+            << "%" << setw(12) << setprecision(2) << p.hitRatio * 100 << endl;
+    }
+}
+
+void printMrcCsv(ostream& out, const SimConfig& cfg, const MrcEstimator& mrc)
+{
+    out << "\ncapacity,predicted_lru_hit_ratio\n";
+    for (const MrcPoint& p : selectMrcPoints(cfg, mrc)) {
+        out << p.capacity << "," << fixed << setprecision(6) << p.hitRatio << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    SimConfig cfg;
+    if (!parseArgs(argc, argv, cfg)) return 2;
+
+    try {
+        Bench::MappedFile file(cfg.trace);
+        if (!resolveFormat(cfg, file)) {
+            cerr << "未知的轨迹格式: " << cfg.format << endl;
+            return 2;
+        }
+
+        if (!cfg.convert.empty()) {
+            uint64_t n = convertTrace(cfg, file);
+            cerr << "已写出 " << n << " 条记录到 " << cfg.convert << endl;
+            return 0;
+        }
+
+        for (const string& policy : cfg.policies) {
+            SimConfig probe = cfg;
+            probe.capacity = 1;
+            probe.bytes = cfg.bytes ? 1 : 0;
+            if (!withPolicy(policy, probe, [](auto&) {})) {
+                cerr << "未知的策略或不支持按字节限制容量: " << policy << endl;
+                return 2;
+            }
+        }
+
+        ofstream fileOut;
+        if (!cfg.out.empty()) {
+            fileOut.open(cfg.out);
+            if (!fileOut) {
+                cerr << "无法写入: " << cfg.out << endl;
+                return 2;
+            }
+        }
+        ostream& out = cfg.out.empty() ? cout : fileOut;
+
+        cerr << "=== cache_sim (轨迹 " << cfg.trace << ", 格式 " << cfg.format << ", "
+             << (cfg.bytes ? "字节容量 " + to_string(cfg.bytes) : "容量 " + to_string(cfg.capacity))
+             << ", 策略数 " << cfg.policies.size() << (cfg.mrc ? " + 命中率曲线" : "")
+             << ", 并行 " << min<size_t>(cfg.jobs, cfg.policies.size() + cfg.mrc)
+             << ") ===" << endl;
+        unique_ptr<MrcEstimator> mrc;
+        if (cfg.mrc) mrc.reset(new MrcEstimator(cfg.capacity, cfg.mrcSamples));
+        vector<SimResult> results = runAll(cfg, file, mrc.get(), cerr);
+
+        if (cfg.output == "csv") {
+            printCsv(out, cfg, results);
+            if (mrc) printMrcCsv(out, cfg, *mrc);
+        } else if (cfg.output == "json") {
+            printJson(out, cfg, results, mrc ? selectMrcPoints(cfg, *mrc) : vector<MrcPoint>());
+        } else {
+            printTable(out, results);
+            if (mrc) printMrc(out, cfg, *mrc);
+        }
+    } catch (const exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -10,6 +10,7 @@
 #include <set>
 #include <list>
 #include "ArcCache/ArcCache.h"
+#include "bench/LatencyHistogram.h"
 
 using namespace Cache;
 using namespace std;
@@ -388,6 +389,227 @@ bool testMemoryConsistency() {
     return successCount > 10; // 至少一半的数据应该仍然正确
 }
 
+// 批量接口：与逐个访问的结果一致，达到门槛的条目同样转入LFU部分
+bool testBatchApi() {
+    ArcCache<int, string> cache(4, 2);
+    cache.putMany({1, 2, 3}, {"one", "two", "three"});
+
+    vector<string> values;
+    vector<bool> found;
+    if (cache.getMany({1, 5, 3}, values, found) != 2) return false;
+    if (!found[0] || found[1] || !found[2]) return false;
+    if (values[0] != "one" || values[2] != "three") return false;
+
+    // 再批量访问一次，1和3达到转换门槛
+    cache.getMany({1, 3}, values, found);
+    for (int i = 10; i < 20; ++i) {
+        cache.put(i, "fill");
+    }
+    // LRU部分被新数据冲刷，1和3仍能从LFU部分命中
+    return cache.getMany({1, 3}, values, found) == 2 && values[0] == "one" && values[1] == "three";
+}
+
+// 按字节限制容量：两个部分都按权重淘汰，大条目会挤出多个小条目
+bool testWeightedCapacity() {
+    auto weigher = [](const int&, const string& v) { return v.size(); };
+    ArcCache<int, string> cache(4096, weigher);
+
+    for (int i = 0; i < 100; ++i) {
+        cache.put(i, string(100, 'a'));
+    }
+    string value;
+    int small = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (cache.get(i, value)) small++;
+    }
+    // 每个条目约100字节加上节点开销，4096字节放不下全部100个
+    if (small == 0 || small >= 40) return false;
+
+    cache.put(1000, string(3000, 'b'));
+    if (!cache.get(1000, value) || value.size() != 3000) return false;
+
+    // 超过整个预算的条目不放入
+    cache.put(2000, string(100000, 'c'));
+    if (cache.get(2000, value)) return false;
+
+    // 已有条目更新成超过整个预算的value时被删除，其它条目不受影响，总权重不超出预算
+    size_t residents = cache.size();
+    cache.put(1000, string(100000, 'd'));
+    if (cache.get(1000, value) || cache.weight() > 4096) return false;
+    return cache.size() == residents - 1;
+}
+
+// TTL：过期条目在两个部分中都按未命中处理，转入LFU部分的条目保留原有的过期时刻
+bool testTtlExpiration() {
+    ArcCache<int, string> cache(10);
+    cache.putWithTtl(1, "short", chrono::milliseconds(30));
+    cache.putWithTtl(2, "long", chrono::milliseconds(10000));
+    cache.put(3, "forever");
+
+    string value;
+    // 多次访问使1转入LFU部分
+    for (int i = 0; i < 3; ++i) {
+        if (!cache.get(1, value) || value != "short") return false;
+    }
+    this_thread::sleep_for(chrono::milliseconds(60));
+    if (cache.get(1, value)) return false;
+    if (!cache.get(2, value) || !cache.get(3, value)) return false;
+
+    // 默认TTL对批量写入同样生效
+    ArcCache<int, int> defaults(100);
+    defaults.setDefaultTtl(chrono::milliseconds(20));
+    defaults.putMany({1, 2, 3}, {1, 2, 3});
+    defaults.putWithTtl(4, 4, chrono::milliseconds(0));
+    vector<int> values;
+    vector<bool> found;
+    if (defaults.getMany({1, 2, 3, 4}, values, found) != 4) return false;
+    this_thread::sleep_for(chrono::milliseconds(50));
+    return defaults.getMany({1, 2, 3, 4}, values, found) == 1 && found[3] && values[3] == 4;
+}
+
+// 每个key只保存一份：进入T2的条目不再占用T1的位置，缓存中的条目数始终不超过容量
+bool testSingleOwnership() {
+    ArcCache<int, int> cache(10, 2);
+    for (int i = 0; i < 10; ++i) {
+        cache.put(i, i);
+    }
+    int value;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 10; ++i) {
+            if (!cache.get(i, value) || value != i) return false;
+        }
+    }
+    if (cache.size() != 10 || cache.weight() != 10) return false;
+
+    mt19937 gen(3);
+    uniform_int_distribution<> keyDis(0, 99);
+    for (int i = 0; i < 20000; ++i) {
+        int key = keyDis(gen);
+        if (i % 3 == 0) {
+            cache.put(key, key);
+        } else if (cache.get(key, value) && value != key) {
+            return false;
+        }
+        if (cache.size() > 10) return false;
+    }
+    return cache.size() == cache.weight();
+}
+
+// 分片ARC：基本读写、批量接口、各分片独立或共享调整p
+bool testHashArcCache() {
+    HashArcCache<int, int> cache(100, 4);
+    if (cache.sliceNum() != 4) return false;
+    for (int i = 0; i < 100; ++i) {
+        cache.put(i, i * 10);
+    }
+    int value;
+    for (int i = 0; i < 100; ++i) {
+        if (cache.get(i, value) && value != i * 10) return false;
+    }
+    size_t total = 0;
+    for (size_t n : cache.sliceSizes()) total += n;
+    if (total != cache.weight() || total > 100) return false;
+
+    vector<int> values;
+    vector<bool> found;
+    cache.putMany({1000, 1001, 1002}, {1, 2, 3});
+    if (cache.getMany({1000, 1001, 1002, 5000}, values, found) != 3) return false;
+    if (values[0] != 1 || values[2] != 3 || found[3]) return false;
+
+    // 在某个分片里写入(分片容量+1)个key，最早的key被驱逐到B1，再读它命中B1使该分片的p增大
+    HashArcCache<int, int> perShard(64, 4);
+    HashArcCache<int, int> shared(64, 4, 2, ArcAdaptation::Shared);
+    auto ghostHit = [](HashArcCache<int, int>& c, size_t slice) {
+        vector<int> keys;
+        for (int k = 0; keys.size() < 17; ++k) {
+            if (c.sliceIndex(k) == slice) keys.push_back(k);
+        }
+        for (int k : keys) c.put(k, k);
+        int v;
+        return !c.get(keys[0], v);
+    };
+    if (!ghostHit(perShard, 0)) return false;
+    vector<size_t> targets = perShard.sliceTargets();
+    if (targets[0] != 1 || targets[1] != 0 || targets[2] != 0 || targets[3] != 0) return false;
+
+    // 共享模式下p的总和只增加1，平均到4个分片后仍为0；每个分片各命中一次后所有分片的p一起变为1
+    if (!ghostHit(shared, 0)) return false;
+    if (shared.sliceTargets()[0] != 0) return false;
+    for (size_t s = 1; s < 4; ++s) {
+        if (!ghostHit(shared, s)) return false;
+    }
+    for (size_t t : shared.sliceTargets()) {
+        if (t != 1) return false;
+    }
+    return true;
+}
+
+// 原始ARC模式：再次访问即进入T2，幽灵命中按两个幽灵链表的大小之比调整p，目录大小不超过2c
+bool testCanonicalArc() {
+    ArcCache<int, int> cache(4, 100, ArcMode::Canonical); // 转换门槛在原始模式下不起作用
+    for (int i = 0; i < 4; ++i) {
+        cache.put(i, i);
+    }
+    int value;
+    if (!cache.get(0, value) || !cache.get(1, value)) return false;
+    ArcStats stats = cache.arcStats();
+    if (stats.t1Weight != 2 || stats.t2Weight != 2 || stats.target != 0) return false;
+
+    // p为0时驱逐T1：2、3进入B1
+    cache.put(4, 4);
+    cache.put(5, 5);
+    stats = cache.arcStats();
+    if (stats.b1Size != 2 || stats.t1Weight != 2) return false;
+    // 写入B1中的key：p增大，该key直接进入T2
+    cache.put(2, 2);
+    stats = cache.arcStats();
+    if (stats.target != 1 || stats.t2Weight != 3 || stats.b1Size + stats.b2Size != 2) return false;
+    if (!cache.get(2, value) || value != 2) return false;
+
+    // 随机负载下检查目录大小限制：|T1|+|B1| <= c，|T1|+|T2|+|B1|+|B2| <= 2c，p不超过c
+    ArcCache<int, int> bounded(50, 2, ArcMode::Canonical);
+    mt19937 gen(11);
+    uniform_int_distribution<> hot(0, 39), cold(0, 999);
+    uniform_int_distribution<> pick(0, 9);
+    for (int i = 0; i < 20000; ++i) {
+        int key = pick(gen) < 6 ? hot(gen) : cold(gen);
+        if (!bounded.get(key, value)) {
+            bounded.put(key, key);
+        } else if (value != key) {
+            return false;
+        }
+        stats = bounded.arcStats();
+        if (stats.t1Weight + stats.b1Weight > 50) return false;
+        if (stats.t1Weight + stats.t2Weight + stats.b1Weight + stats.b2Weight > 100) return false;
+        if (stats.target > 50 || bounded.size() > 50) return false;
+    }
+    // 热点集合(40个)小于容量，最终应大部分留在T2中
+    return bounded.arcStats().t2Weight >= 30;
+}
+
+// 运行统计：幽灵链表命中计入ghostHits，分片缓存的统计可以合并
+bool testStats() {
+    ArcCache<int, int> cache(2, 2);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);        // 1被驱逐到B1
+    int value;
+    cache.get(1, value);    // 未命中，命中B1
+    cache.put(3, 30);
+    CacheStats stats = cache.stats();
+    if (stats.inserts != 3 || stats.updates != 1 || stats.evictions != 1) return false;
+    if (stats.misses != 1 || stats.ghostHits != 1 || stats.hits != 0) return false;
+
+    HashArcCache<int, int> sharded(64, 4);
+    for (int i = 0; i < 200; ++i) sharded.put(i, i);
+    for (int i = 0; i < 200; ++i) sharded.get(i, value);
+    CacheStats merged;
+    for (const CacheStats& s : sharded.sliceStats()) merged += s;
+    CacheStats total = sharded.stats();
+    return total.hits + total.misses == 200 && total.ghostHits == merged.ghostHits &&
+           total.ghostHits > 0 && total.inserts - total.evictions == sharded.weight();
+}
+
 // 性能测试
 void performanceTest() {
     cout << "\n=== ARC缓存性能测试 ===" << endl;
@@ -396,6 +618,7 @@ void performanceTest() {
     const int operations = 50000;
     
     ArcCache<int, int> cache(cacheSize, 3);
+    Bench::OpLatency latency;
     
     auto start = chrono::high_resolution_clock::now();
     
@@ -409,11 +632,14 @@ void performanceTest() {
         int key = keyDis(gen);
         int op = opDis(gen);
         
+        uint64_t opStart = Bench::TickClock::now();
         if (op < 70) { // 70% put操作
             cache.put(key, key * 2);
+            latency.put.recordSince(opStart);
         } else { // 30% get操作
             int value;
             cache.get(key, value);
+            latency.get.recordSince(opStart);
         }
     }
     
@@ -423,6 +649,8 @@ void performanceTest() {
     cout << "执行 " << operations << " 次混合操作耗时: " << duration.count() << " ms" << endl;
     cout << "平均每次操作耗时: " << (double)duration.count() / operations << " ms" << endl;
     cout << "操作吞吐量: " << (operations * 1000) / duration.count() << " ops/sec" << endl;
+    Bench::printLatencyHeader(cout);
+    Bench::printLatencyRows(cout, "ARC", latency);
 }
 
 int main() {
@@ -442,7 +670,14 @@ int main() {
         {"压力负载测试", testStressLoad},
         {"自适应行为验证", testAdaptiveBehavior},
         {"大量数据测试", testLargeDataSet},
-        {"内存一致性测试", testMemoryConsistency}
+        {"内存一致性测试", testMemoryConsistency},
+        {"批量读写接口", testBatchApi},
+        {"按字节限制容量", testWeightedCapacity},
+        {"TTL过期", testTtlExpiration},
+        {"每个key只保存一份", testSingleOwnership},
+        {"分片ARC", testHashArcCache},
+        {"原始ARC模式", testCanonicalArc},
+        {"运行统计", testStats}
     };
     
     int passedTests = 0;
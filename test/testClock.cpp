@@ -0,0 +1,196 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <random>
+#include "ClockCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 测试辅助函数
+void printTestResult(const string& testName, bool passed) {
+    cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << endl;
+}
+
+// 测试1: 基本的put和get功能
+template<typename CacheType>
+bool testBasicPutGet() {
+    CacheType cache(3);
+
+    string value;
+    if (cache.get(1, value)) return false;
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    if (!cache.get(1, value) || value != "one") return false;
+    if (!cache.get(2, value) || value != "two") return false;
+    if (!cache.get(3, value) || value != "three") return false;
+    if (cache.get(4, value)) return false;
+
+    // 更新已存在的key
+    cache.put(2, "TWO");
+    return cache.get(2) == "TWO";
+}
+
+// 测试2: CLOCK的二次机会淘汰
+bool testClockSecondChance() {
+    ClockCache<int, string> cache(3);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    // 只有1被引用过，插入4时指针跳过1，淘汰2
+    string value;
+    cache.get(1, value);
+    cache.put(4, "four");
+
+    if (cache.get(2, value)) return false;
+    if (!cache.get(1, value) || value != "one") return false;
+    if (!cache.get(3, value) || !cache.get(4, value)) return false;
+    return true;
+}
+
+// 测试3: 零容量与容量为1
+template<typename CacheType>
+bool testSmallCapacity() {
+    CacheType empty(0);
+    empty.put(1, "one");
+    string value;
+    if (empty.get(1, value)) return false;
+
+    CacheType one(1);
+    one.put(1, "one");
+    if (!one.get(1, value) || value != "one") return false;
+    one.put(2, "two");
+    if (one.get(1, value)) return false;
+    return one.get(2, value) && value == "two";
+}
+
+// 测试4: CLOCK-Pro扫描抵抗：反复访问的热数据不应被一次性扫描全部冲掉
+bool testClockProScanResistance() {
+    ClockProCache<int, int> cache(100);
+    int value;
+
+    // 热数据反复访问，期间夹杂扫描，使其经过测试期升级为热页
+    for (int round = 0; round < 20; ++round) {
+        for (int key = 0; key < 50; ++key) {
+            if (!cache.get(key, value)) cache.put(key, key);
+        }
+        for (int key = 0; key < 60; ++key) {
+            int scanKey = 10000 + round * 60 + key;
+            if (!cache.get(scanKey, value)) cache.put(scanKey, scanKey);
+        }
+    }
+
+    // 一次大范围扫描
+    for (int key = 100000; key < 100500; ++key) {
+        cache.put(key, key);
+    }
+
+    int survived = 0;
+    for (int key = 0; key < 50; ++key) {
+        if (cache.get(key, value)) survived++;
+    }
+    // LRU和CLOCK在这里会全部被冲掉
+    return survived >= 40;
+}
+
+// CLOCK-Pro测试页：读和写都识别为测试期内的再次访问，同一测试页先读后写只计一次
+bool testClockProTestPages() {
+    ClockProCache<int, int> cache(2);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(3, 3);    // 1在测试期内被淘汰，成为测试页
+    int value;
+    if (cache.get(1, value)) return false;
+    if (cache.stats().ghostHits != 1) return false;
+    cache.put(1, 10);   // 以热页身份重新驻留
+    if (cache.stats().ghostHits != 1) return false;
+    return cache.get(1, value) && value == 10;
+}
+
+// 测试5: 多线程安全性(读路径只持有共享锁)
+template<typename CacheType>
+bool testThreadSafety() {
+    CacheType cache(200);
+    const int numThreads = 8;
+    atomic<bool> testPassed{true};
+    vector<thread> threads;
+
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            mt19937 gen(t);
+            for (int i = 0; i < 5000; ++i) {
+                int key = gen() % 400;
+                if (i % 5 == 0) {
+                    cache.put(key, to_string(key));
+                } else if (i % 97 == 0) {
+                    cache.remove(key);
+                } else {
+                    string value;
+                    if (cache.get(key, value) && value != to_string(key)) {
+                        testPassed = false;
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return testPassed.load();
+}
+
+int main() {
+    cout << "开始CLOCK/CLOCK-Pro缓存测试..." << endl;
+    cout << "=========================" << endl;
+
+    vector<pair<string, function<bool()>>> tests = {
+        {"CLOCK基本Put/Get功能", testBasicPutGet<ClockCache<int, string>>},
+        {"CLOCK-Pro基本Put/Get功能", testBasicPutGet<ClockProCache<int, string>>},
+        {"CLOCK二次机会淘汰", testClockSecondChance},
+        {"CLOCK小容量边界", testSmallCapacity<ClockCache<int, string>>},
+        {"CLOCK-Pro小容量边界", testSmallCapacity<ClockProCache<int, string>>},
+        {"CLOCK-Pro扫描抵抗", testClockProScanResistance},
+        {"CLOCK-Pro测试页", testClockProTestPages},
+        {"CLOCK多线程安全", testThreadSafety<ClockCache<int, string>>},
+        {"CLOCK-Pro多线程安全", testThreadSafety<ClockProCache<int, string>>}
+    };
+
+    int passedTests = 0;
+    int totalTests = tests.size();
+
+    for (const auto& test : tests) {
+        try {
+            auto start = chrono::high_resolution_clock::now();
+            bool result = test.second();
+            auto end = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+            printTestResult(test.first + " (" + to_string(duration.count()) + "ms)", result);
+            if (result) passedTests++;
+        } catch (const exception& e) {
+            printTestResult(test.first + " (异常: " + e.what() + ")", false);
+        } catch (...) {
+            printTestResult(test.first + " (未知异常)", false);
+        }
+    }
+
+    cout << "\n=========================" << endl;
+    cout << "测试结果: " << passedTests << "/" << totalTests << " 通过" << endl;
+
+    if (passedTests == totalTests) {
+        cout << "所有测试通过! ✓" << endl;
+    } else {
+        cout << "有 " << (totalTests - passedTests) << " 个测试需要检查! " << endl;
+    }
+
+    return passedTests == totalTests ? 0 : 1;
+}
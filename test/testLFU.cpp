@@ -6,7 +6,13 @@
 #include <chrono>
 #include <atomic>
 #include <functional>
+#include <random>
+#include <set>
+#include <map>
+#include <climits>
 #include "LFUCache.h"
+#include "CompactLfuCache.h"
+#include "bench/LatencyHistogram.h"
 
 using namespace Cache;
 using namespace std;
@@ -377,6 +383,132 @@ bool testFrequencyGrowthScenario() {
     return true;
 }
 
+// 测试13: 两种老化方式下，淘汰的总是有效访问频次最小的条目，老化后频次会下降
+bool testAgingModes() {
+    for (LfuAging aging : {LfuAging::Eager, LfuAging::Lazy}) {
+        const int capacity = 50;
+        LFUCache<int, int> cache(capacity, 4, aging);
+        mt19937 gen(7);
+        uniform_int_distribution<> keyDis(0, 199);
+        uniform_int_distribution<> opDis(0, 99);
+        set<int> present;
+
+        for (int i = 0; i < 20000; ++i) {
+            int key = keyDis(gen);
+            if (opDis(gen) < 70) {
+                int value;
+                if (cache.get(key, value) != (present.count(key) > 0)) return false;
+                continue;
+            }
+            if (present.count(key) || (int)present.size() < capacity) {
+                cache.put(key, key);
+                present.insert(key);
+                continue;
+            }
+
+            // 缓存已满时插入新key：被淘汰的key的频次必须是插入前的最小频次
+            long long minFreq = LLONG_MAX;
+            map<int, long long> freqs;
+            for (int k : present) {
+                long long freq = 0;
+                if (!cache.frequency(k, freq)) return false;
+                freqs[k] = freq;
+                minFreq = min(minFreq, freq);
+            }
+            cache.put(key, key);
+            int evicted = -1;
+            for (int k : present) {
+                long long freq;
+                if (!cache.frequency(k, freq)) evicted = k;
+            }
+            if (evicted < 0 || freqs[evicted] != minFreq) return false;
+            present.erase(evicted);
+            present.insert(key);
+        }
+
+        // 频繁访问的key触发老化后，频次不会无限增长
+        LFUCache<int, int> hot(2, 10, aging);
+        hot.put(1, 1);
+        for (int i = 0; i < 1000; ++i) hot.get(1);
+        long long freq = 0;
+        if (!hot.frequency(1, freq) || freq > 11) return false;
+    }
+    return true;
+}
+
+// 测试14: 紧凑LFU：基本读写，淘汰的总是估算频次最小的条目，对数计数器的估算值有界且单调
+bool testCompactLfu() {
+    CompactLfuCache<int, string> basic(2);
+    basic.put(1, "one");
+    basic.put(2, "two");
+    basic.get(1);
+    basic.put(3, "three"); // 淘汰访问次数最少的2
+    string value;
+    if (!basic.get(1, value) || value != "one") return false;
+    if (basic.get(2, value) || !basic.get(3, value) || value != "three") return false;
+    if (basic.tryEmplace(3, "x") || basic.get(3) != "three") return false;
+    basic.remove(3);
+    if (basic.get(3, value) || basic.size() != 1) return false;
+
+    CompactLfuCache<int, int> empty(0);
+    empty.put(1, 1);
+    int v;
+    if (empty.get(1, v)) return false;
+
+    for (int bits : {4, 8}) {
+        const int capacity = 50;
+        CompactLfuCache<int, int> cache(capacity, bits);
+        mt19937 gen(11);
+        uniform_int_distribution<> keyDis(0, 199);
+        uniform_int_distribution<> opDis(0, 99);
+        set<int> present;
+
+        for (int i = 0; i < 20000; ++i) {
+            int key = keyDis(gen);
+            if (opDis(gen) < 70) {
+                if (cache.get(key, v) != (present.count(key) > 0)) return false;
+                continue;
+            }
+            if (present.count(key) || (int)present.size() < capacity) {
+                cache.put(key, key);
+                present.insert(key);
+                continue;
+            }
+
+            long long minFreq = LLONG_MAX;
+            map<int, long long> freqs;
+            for (int k : present) {
+                long long freq = 0;
+                if (!cache.frequency(k, freq)) return false;
+                freqs[k] = freq;
+                minFreq = min(minFreq, freq);
+            }
+            cache.put(key, key);
+            int evicted = -1;
+            for (int k : present) {
+                long long freq;
+                if (!cache.frequency(k, freq)) evicted = k;
+            }
+            if (evicted < 0 || freqs[evicted] != minFreq) return false;
+            present.erase(evicted);
+            present.insert(key);
+        }
+
+        // 估算值随访问单调不减，大量访问后仍在合理范围内(对数计数器有随机误差)
+        CompactLfuCache<int, int> hot(2, bits);
+        hot.put(1, 1);
+        long long last = 0;
+        for (int i = 0; i < 100000; ++i) {
+            hot.get(1);
+            long long freq = 0;
+            if (!hot.frequency(1, freq) || freq < last) return false;
+            last = freq;
+        }
+        if (last < 100000 / 10 || last > 100000 * 10) return false;
+    }
+    return true;
+}
+
 // 性能测试
 void performanceTest() {
     cout << "\n=== 性能测试 ===" << endl;
@@ -385,18 +517,23 @@ void performanceTest() {
     const int operations = 100000;
     
     LFUCache<int, int> cache(cacheSize);
+    Bench::OpLatency latency;
     
     auto start = chrono::high_resolution_clock::now();
     
     // 执行大量put操作
     for (int i = 0; i < operations; ++i) {
+        uint64_t opStart = Bench::TickClock::now();
         cache.put(i % (cacheSize * 2), i);  // 故意超出容量以测试淘汰策略
+        latency.put.recordSince(opStart);
     }
     
     // 执行大量get操作
     int value;
     for (int i = 0; i < operations; ++i) {
+        uint64_t opStart = Bench::TickClock::now();
         cache.get(i % (cacheSize * 2), value);
+        latency.get.recordSince(opStart);
     }
     
     auto end = chrono::high_resolution_clock::now();
@@ -404,6 +541,38 @@ void performanceTest() {
     
     cout << "执行 " << operations * 2 << " 次操作耗时: " << duration.count() << " ms" << endl;
     cout << "平均每次操作耗时: " << (double)duration.count() / (operations * 2) << " ms" << endl;
+    Bench::printLatencyHeader(cout);
+    Bench::printLatencyRows(cout, "LFU", latency);
+}
+
+// 运行统计：淘汰与频次老化次数，两种老化方式都计入agingPasses
+bool testStats() {
+    LFUCache<int, int> cache(10, 4);
+    int value;
+    for (int i = 0; i < 20; ++i) {
+        cache.put(i, i);
+    }
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 10; i < 20; ++i) cache.get(i, value);
+    }
+    cache.get(0, value);
+    CacheStats stats = cache.stats();
+    if (stats.inserts != 20 || stats.evictions != 10) return false;
+    if (stats.hits != 100 || stats.misses != 1 || stats.agingPasses == 0) return false;
+
+    LFUCache<int, int> lazy(10, 4, LfuAging::Lazy);
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 10; ++i) lazy.put(i, i);
+    }
+    stats = lazy.stats();
+    if (stats.inserts != 10 || stats.updates != 90 || stats.agingPasses == 0) return false;
+
+    KHashLfuCache<int, int> sharded(100, 4);
+    for (int i = 0; i < 200; ++i) sharded.put(i, i);
+    CacheStats merged;
+    for (const CacheStats& s : sharded.sliceStats()) merged += s;
+    return merged.inserts == 200 && sharded.stats().evictions == merged.evictions &&
+           merged.inserts - merged.evictions == sharded.weight();
 }
 
 int main() {
@@ -422,7 +591,10 @@ int main() {
         {"purge功能", testPurgeFunction},
         {"get方法重载", testGetOverload},
         {"相同频率FIFO淘汰", testSameFrequencyEviction},
-        {"频率增长详细场景", testFrequencyGrowthScenario}
+        {"频率增长详细场景", testFrequencyGrowthScenario},
+        {"Eager/Lazy频次老化", testAgingModes},
+        {"紧凑LFU(对数计数器)", testCompactLfu},
+        {"运行统计", testStats}
     };
     
     int passedTests = 0;
@@ -8,6 +8,8 @@
 #include <functional>
 #include <random>
 #include <set>
+#include <cmath>
+#include <stdexcept>
 #include "LRUCache.h"
 
 using namespace Cache;
@@ -278,7 +280,67 @@ bool testKLruKCacheBasic() {
     }
 }
 
+// LRU-K晋升与历史淘汰：历史暂存的value随历史记录一起淘汰
+bool testKLruKPromotion() {
+    KLruKCache<int, string> cache(2, 2, 2);
+
+    cache.put(1, "one");
+    uint64_t stamp = 0;
+    if (cache.size() != 0 || cache.historySize() != 1 || cache.kthAccessTime(1, stamp)) return false;
+
+    // 第二次访问凑满k次，带着暂存的value晋升
+    string value;
+    if (!cache.get(1, value) || value != "one") return false;
+    if (cache.size() != 1 || cache.historySize() != 0 || !cache.kthAccessTime(1, stamp)) return false;
+
+    // 历史队列有界，最早的10连同value一起被淘汰
+    cache.put(10, "ten");
+    cache.put(11, "eleven");
+    cache.put(12, "twelve");
+    if (cache.historySize() != 2) return false;
+    if (cache.get(10, value)) return false;
+    return cache.get(12, value) && value == "twelve";
+}
+
+// LRU-K历史记录只有key：没写入过的key未命中不建记录，历史中暂存的value有上限，超出时丢掉最久未访问的
+bool testKLruKHistoryValues() {
+    KLruKCache<int, string> cache(2, 10, 2, 1); // 历史中最多暂存1个value
+    string value;
+    if (cache.get(5, value) || cache.historySize() != 0) return false;
+
+    cache.put(1, "one");
+    cache.put(2, "two");   // 1的value被丢掉，访问记录还在
+    if (cache.historySize() != 2 || cache.historyValues() != 1) return false;
+
+    // 1凑满k次但没有value，不能晋升；再写入时直接晋升
+    if (cache.get(1, value) || cache.size() != 0) return false;
+    cache.put(1, "uno");
+    if (cache.size() != 1 || cache.historySize() != 1 || !cache.get(1, value) || value != "uno") return false;
+    return cache.get(2, value) && value == "two" && cache.size() == 2 && cache.historyValues() == 0;
+}
+
 // 改进的分片缓存测试
+// LRU-K删除：主缓存和历史队列中的key都能删除，删除后访问记录清零，重新写入要再凑满k次
+bool testKLruKRemove() {
+    KLruKCache<int, string> cache(2, 2, 2);
+    cache.put(1, "one");
+    cache.put(1, "one");   // 凑满2次，晋升到主缓存
+    cache.put(2, "two");   // 只在历史队列中
+    if (cache.size() != 1 || cache.historySize() != 1) return false;
+
+    cache.remove(1);
+    cache.remove(2);
+    cache.remove(3);       // 不存在的key
+    string value;
+    uint64_t stamp = 0;
+    if (cache.size() != 0 || cache.historySize() != 0 || cache.kthAccessTime(1, stamp)) return false;
+
+    // 释放的节点被复用，删除前的访问次数不再计入
+    cache.put(1, "uno");
+    if (cache.size() != 0 || cache.historySize() != 1) return false;
+    return cache.get(1, value) && value == "uno" && cache.size() == 1;
+}
+
 bool testHashLruCachesAdvanced() {
     HashLruCaches<int, string> cache(100, 4);
     
@@ -315,6 +377,379 @@ bool testHashLruCachesAdvanced() {
     return foundSome;
 }
 
+// 移动语义、就地构造与visit接口测试
+bool testMoveAndVisitApi() {
+    LRUCache<int, string> cache(2);
+
+    string big(1000, 'x');
+    cache.put(1, std::move(big));
+    cache.emplace(2, 5, 'y'); // 就地构造 "yyyyy"
+
+    // tryEmplace不覆盖已存在的key
+    if (cache.tryEmplace(2, "other")) return false;
+
+    size_t len = 0;
+    if (!cache.visit(1, [&](const string& v) { len = v.size(); }) || len != 1000) return false;
+
+    string value;
+    if (!cache.get(2, value) || value != "yyyyy") return false;
+
+    // visit同样会更新访问顺序：此时1比2更久未访问，插入3应淘汰1
+    cache.put(3, "three");
+    if (cache.visit(1, [](const string&) {})) return false;
+    return cache.get(3) == "three";
+}
+
+// 读缓冲模式：单线程下与普通LRU顺序一致，多线程下保持线程安全
+bool testBufferedReadMode() {
+    LRUCache<int, string> cache(3, true);
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    string value;
+    if (!cache.get(1, value) || value != "one") return false;
+
+    // 写操作会先回放读缓冲，1变为最新，应淘汰2
+    cache.put(4, "four");
+    if (cache.get(2, value)) return false;
+    if (!cache.get(1, value) || !cache.get(3, value) || !cache.get(4, value)) return false;
+
+    HashLruCaches<int, int> shared(200, 4, true);
+    atomic<bool> passed{true};
+    vector<thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            mt19937 gen(t);
+            for (int i = 0; i < 5000; ++i) {
+                int key = gen() % 400;
+                if (i % 4 == 0) {
+                    shared.put(key, key * 3);
+                } else {
+                    int v;
+                    if (shared.get(key, v) && v != key * 3) passed = false;
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    return passed.load();
+}
+
+// 批量接口：结果与逐个get一致，分片缓存按分片分组后结果仍按原顺序返回
+bool testBatchApi() {
+    LRUCache<int, string> cache(3);
+    cache.putMany({1, 2, 3}, {"one", "two", "three"});
+
+    vector<string> values;
+    vector<bool> found;
+    if (cache.getMany({3, 4, 1}, values, found) != 2) return false;
+    if (!found[0] || found[1] || !found[2]) return false;
+    if (values[0] != "three" || values[2] != "one") return false;
+
+    // 批量读取同样更新访问顺序：2是最久未访问的，应被淘汰
+    cache.put(4, "four");
+    if (cache.get(2, values[1])) return false;
+
+    // 通过基类指针走同一条代码路径
+    CachePolicy<int, string>& policy = cache;
+    if (policy.getMany({1, 4}, values, found) != 2 || values[1] != "four") return false;
+
+    HashLruCaches<int, int> sharded(1000, 8);
+    vector<int> keys, vals;
+    for (int i = 0; i < 500; ++i) {
+        keys.push_back(i * 16);
+        vals.push_back(i);
+    }
+    sharded.putMany(keys, vals);
+    keys.push_back(-1); // 不存在的key
+    vector<int> out;
+    if (sharded.getMany(keys, out, found) != 500 || found.back()) return false;
+    for (int i = 0; i < 500; ++i) {
+        if (!found[i] || out[i] != i) return false;
+    }
+    return true;
+}
+
+// 按字节限制容量：淘汰到总权重不超出预算，超出整个预算的条目不放入，分片共享全局预算
+bool testWeightedCapacity() {
+    auto weigher = [](const int&, const string& v) { return v.size(); };
+    const size_t entry = 100 + LRUCache<int, string>::kEntryOverhead;
+
+    LRUCache<int, string> cache(3 * entry, weigher);
+    for (int i = 1; i <= 3; ++i) {
+        cache.put(i, string(100, 'a'));
+    }
+    if (cache.size() != 3 || cache.weight() != 3 * entry) return false;
+
+    // 一个大条目需要淘汰两个小条目才放得下
+    cache.put(4, string(250, 'b'));
+    string value;
+    if (cache.get(1, value) || cache.get(2, value)) return false;
+    if (!cache.get(3, value) || !cache.get(4, value)) return false;
+
+    cache.put(5, string(10000, 'c'));
+    if (cache.get(5, value) || cache.size() != 2) return false;
+
+    HashLruCaches<int, string> sharded(50 * entry, 4, weigher);
+    for (int i = 0; i < 1000; ++i) {
+        sharded.put(i, string(100, 'd'));
+    }
+    // 全局预算允许每个分片最多超出一个条目
+    return sharded.weight() <= 50 * entry + sharded.sliceNum() * entry && sharded.weight() >= 40 * entry;
+}
+
+// TTL：过期条目立即按未命中处理并被回收，重新写入会以新的TTL为准，未设TTL的条目不受影响
+bool testTtlExpiration() {
+    LRUCache<int, string> cache(10);
+    cache.putWithTtl(1, "short", chrono::milliseconds(20));
+    cache.putWithTtl(2, "long", chrono::milliseconds(10000));
+    cache.put(3, "forever");
+    cache.putWithTtl(4, "renewed", chrono::milliseconds(20));
+    cache.putWithTtl(4, "renewed", chrono::milliseconds(10000));
+
+    string value;
+    if (!cache.get(1, value) || value != "short") return false;
+    this_thread::sleep_for(chrono::milliseconds(50));
+    if (cache.get(1, value)) return false;
+    if (!cache.get(2, value) || !cache.get(3, value) || !cache.get(4, value)) return false;
+    // 过期的key可以用tryEmplace重新插入
+    if (!cache.tryEmplace(1, "again") || !cache.get(1, value) || value != "again") return false;
+
+    // 默认TTL：到期后由时间轮回收，size随之减少
+    LRUCache<int, int> defaults(100);
+    defaults.setDefaultTtl(chrono::milliseconds(20));
+    for (int i = 0; i < 50; ++i) {
+        defaults.put(i, i);
+    }
+    defaults.putWithTtl(100, 100, chrono::milliseconds(0));
+    if (defaults.size() != 51) return false;
+    this_thread::sleep_for(chrono::milliseconds(50));
+    if (defaults.size() != 1 || defaults.get(100) != 100) return false;
+
+    HashLruCaches<int, int> sharded(100, 4);
+    sharded.setDefaultTtl(chrono::milliseconds(20));
+    sharded.put(1, 1);
+    sharded.putWithTtl(2, 2, chrono::milliseconds(10000));
+    this_thread::sleep_for(chrono::milliseconds(50));
+    int v = 0;
+    return !sharded.get(1, v) && sharded.get(2, v) && v == 2;
+}
+
+// 运行统计：命中/未命中/写入/更新/淘汰计数，分片统计之和等于合并后的快照，多线程下计数不丢失
+// 时间轮：重复登记同一节点只挪动位置，撤销后不再到期，每个节点恰好在过期时刻到期一次
+struct TestTimer : TimerLink {
+    uint64_t expireAt = 0;
+    int fired = 0;
+    uint64_t firedAt = 0;
+};
+
+bool testTimerWheel() {
+    const uint64_t start = 1000;
+    TimerWheel<TestTimer> wheel(start);
+    vector<TestTimer> nodes(200);
+    mt19937_64 rng(3);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        // 覆盖各层与溢出链表(超过2^24ms)
+        uint64_t range = i % 4 == 0 ? 20000000 : (i % 4 == 1 ? 300000 : (i % 4 == 2 ? 5000 : 60));
+        nodes[i].expireAt = start + 1 + rng() % range;
+        wheel.schedule(&nodes[i]);
+    }
+    // 同一节点反复续期：时间轮里仍只有一条
+    for (int i = 0; i < 1000; ++i) {
+        nodes[0].expireAt = start + 1 + rng() % 20000000;
+        wheel.schedule(&nodes[0]);
+    }
+    if (wheel.size() != nodes.size()) return false;
+    wheel.cancel(&nodes[1]);
+    wheel.cancel(&nodes[1]);
+    if (wheel.size() != nodes.size() - 1 || nodes[1].scheduled()) return false;
+
+    uint64_t now = start;
+    auto advanceTo = [&](uint64_t t) {
+        wheel.advance(t, [t](TestTimer* node) {
+            ++node->fired;
+            node->firedAt = t;
+        });
+        now = t;
+    };
+    // 分多步推进，每步之后检查：过期时刻不晚于now的恰好到期一次，且在跨过过期时刻的那一步到期
+    uint64_t previous = start;
+    for (uint64_t t : {start + 30, start + 64, start + 4000, start + 300000, start + 20000001}) {
+        advanceTo(t);
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (i == 1) {
+                if (nodes[i].fired != 0) return false;
+                continue;
+            }
+            bool due = nodes[i].expireAt <= now;
+            if (nodes[i].fired != (due ? 1 : 0)) return false;
+            if (due && nodes[i].expireAt > previous && nodes[i].firedAt != now) return false;
+        }
+        previous = now;
+    }
+    return wheel.empty();
+}
+
+bool testStats() {
+    LRUCache<int, int> cache(2);
+    cache.put(1, 1);
+    cache.put(2, 2);
+    cache.put(1, 10);   // 更新
+    cache.put(3, 3);    // 淘汰2
+    int value;
+    cache.get(1, value);
+    cache.get(2, value);
+    CacheStats stats = cache.stats();
+    if (stats.hits != 1 || stats.misses != 1 || stats.inserts != 3 ||
+        stats.updates != 1 || stats.evictions != 1) return false;
+
+    HashLruCaches<int, int> sharded(400, 4);
+    const int numThreads = 4;
+    const int perThread = 2000;
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&sharded, t]() {
+            int v;
+            for (int i = 0; i < perThread; ++i) {
+                int key = (i * 7 + t) % 1000;
+                if (!sharded.get(key, v)) sharded.put(key, key);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+
+    CacheStats total = sharded.stats();
+    CacheStats merged;
+    for (const CacheStats& s : sharded.sliceStats()) merged += s;
+    if (total.hits != merged.hits || total.evictions != merged.evictions) return false;
+    // 每次get计一次命中或未命中，每次未命中写入一次(并发时可能变成更新)
+    if (total.hits + total.misses != static_cast<uint64_t>(numThreads * perThread)) return false;
+    if (total.inserts + total.updates != total.misses) return false;
+    return total.inserts - total.evictions == sharded.weight();
+}
+
+bool testMissRatioCurve() {
+    const int capacity = 2000;
+    const int keySpace = 50000;
+    HashLruCaches<int, int> sharded(capacity, 4);
+    LRUCache<int, int> full(capacity);
+    LRUCache<int, int> half(capacity / 2);
+    MrcEstimator mrc(capacity);
+    sharded.attachMrc(&mrc);
+    if (sharded.mrc() != &mrc) return false;
+
+    // 偏斜的访问：key = keySpace * u^4，小key访问远多于大key
+    mt19937 rng(42);
+    uniform_real_distribution<double> uniform(0.0, 1.0);
+    int v;
+    uint64_t fullHits = 0, halfHits = 0, gets = 0;
+    for (int i = 0; i < 300000; ++i) {
+        double u = uniform(rng);
+        int key = static_cast<int>(keySpace * u * u * u * u);
+        ++gets;
+        if (full.get(key, v)) ++fullHits; else full.put(key, key);
+        if (half.get(key, v)) ++halfHits; else half.put(key, key);
+        if (!sharded.get(key, v)) sharded.put(key, key);
+    }
+    if (mrc.references() != gets) return false;
+
+    double fullRatio = static_cast<double>(fullHits) / gets;
+    double halfRatio = static_cast<double>(halfHits) / gets;
+    if (abs(mrc.hitRatioAt(capacity) - fullRatio) > 0.05) return false;
+    if (abs(mrc.hitRatioAt(capacity / 2) - halfRatio) > 0.05) return false;
+
+    // 曲线单调不减，覆盖1%~400%
+    vector<MrcPoint> curve = mrc.curve();
+    if (curve.size() != 400 || curve.back().capacity != static_cast<size_t>(capacity) * 4) return false;
+    for (size_t i = 1; i < curve.size(); ++i) {
+        if (curve[i].hitRatio < curve[i - 1].hitRatio) return false;
+    }
+
+    // 解除后不再记录
+    sharded.attachMrc(nullptr);
+    sharded.get(1, v);
+    return mrc.references() == gets;
+}
+
+// numThreads个线程同时对同一个key调用getOrLoad，结果放进results，异常次数计入failures
+template<typename CacheType, typename Loader>
+void loadConcurrently(CacheType& cache, int key, Loader loader, int numThreads,
+                      vector<int>& results, atomic<int>& failures) {
+    results.assign(numThreads, -1);
+    atomic<int> ready{0};
+    atomic<bool> go{false};
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            ++ready;
+            while (!go) this_thread::yield();
+            try {
+                results[t] = cache.getOrLoad(key, loader);
+            } catch (const runtime_error&) {
+                ++failures;
+            }
+        });
+    }
+    while (ready < numThreads) this_thread::yield();
+    go = true;
+    for (auto& th : threads) th.join();
+}
+
+bool testGetOrLoad() {
+    const int numThreads = 16;
+    atomic<int> backendCalls{0};
+    auto slowLoader = [&backendCalls](int key) {
+        ++backendCalls;
+        this_thread::sleep_for(chrono::milliseconds(100));
+        return key * 2;
+    };
+    vector<int> results;
+    atomic<int> failures{0};
+
+    // 未命中时加载并写入，之后直接命中
+    LRUCache<int, int> cache(10);
+    if (cache.getOrLoad(5, slowLoader) != 10 || cache.getOrLoad(5, slowLoader) != 10) return false;
+    if (backendCalls != 1 || cache.get(5) != 10) return false;
+
+    // 并发未命中只加载一次，所有调用者得到同一个结果，之后直接命中
+    backendCalls = 0;
+    loadConcurrently(cache, 7, slowLoader, numThreads, results, failures);
+    if (backendCalls != 1 || failures != 0 || cache.loadsInFlight() != 0) return false;
+    for (int r : results) if (r != 14) return false;
+    if (cache.getOrLoad(7, slowLoader) != 14 || backendCalls != 1) return false;
+
+    // 加载的异常抛给所有等待者，不写入缓存，下次调用重新加载
+    atomic<int> failingCalls{0};
+    auto failingLoader = [&failingCalls](int) -> int {
+        ++failingCalls;
+        this_thread::sleep_for(chrono::milliseconds(100));
+        throw runtime_error("backend unavailable");
+    };
+    loadConcurrently(cache, 8, failingLoader, numThreads, results, failures);
+    if (failingCalls != 1 || failures != numThreads || cache.loadsInFlight() != 0) return false;
+    int v;
+    if (cache.get(8, v)) return false;
+    if (cache.getOrLoad(8, slowLoader) != 16 || backendCalls != 2) return false;
+
+    // 分片缓存按分片合并；加载期间同一分片的其它key照常读写(加载不持有分片锁)
+    HashLruCaches<int, int> sharded(64, 1);
+    sharded.put(1, 100);
+    backendCalls = 0;
+    failures = 0;
+    thread herd([&]() { loadConcurrently(sharded, 9, slowLoader, numThreads, results, failures); });
+    this_thread::sleep_for(chrono::milliseconds(20));
+    auto start = chrono::steady_clock::now();
+    bool otherKeyOk = sharded.get(1, v) && v == 100;
+    sharded.put(2, 200);
+    auto blocked = chrono::steady_clock::now() - start;
+    herd.join();
+    if (!otherKeyOk || blocked > chrono::milliseconds(50)) return false;
+    if (backendCalls != 1 || failures != 0 || sharded.loadsInFlight() != 0) return false;
+    for (int r : results) if (r != 18) return false;
+    return sharded.get(9, v) && v == 18;
+}
+
 int main() {
     cout << "开始改进的LRU缓存测试..." << endl;
     cout << "=========================" << endl;
@@ -329,7 +764,19 @@ int main() {
         {"内存一致性测试", testMemoryConsistency},
         {"压力负载测试", testStressLoad},
         {"LRU-K基本功能", testKLruKCacheBasic},
-        {"高级分片缓存测试", testHashLruCachesAdvanced}
+        {"LRU-K晋升与历史淘汰", testKLruKPromotion},
+        {"LRU-K删除", testKLruKRemove},
+        {"LRU-K历史value有界", testKLruKHistoryValues},
+        {"高级分片缓存测试", testHashLruCachesAdvanced},
+        {"移动语义与visit接口", testMoveAndVisitApi},
+        {"读缓冲模式", testBufferedReadMode},
+        {"批量读写接口", testBatchApi},
+        {"按字节限制容量", testWeightedCapacity},
+        {"TTL过期", testTtlExpiration},
+        {"时间轮登记与撤销", testTimerWheel},
+        {"运行统计", testStats},
+        {"未命中率曲线估计", testMissRatioCurve},
+        {"getOrLoad与合并并发加载", testGetOrLoad}
     };
     
     int passedTests = 0;
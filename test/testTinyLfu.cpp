@@ -0,0 +1,218 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <random>
+#include "TinyLfuCache.h"
+#include "LRUCache.h"
+
+using namespace Cache;
+using namespace std;
+
+// 测试辅助函数
+void printTestResult(const string& testName, bool passed) {
+    cout << "[" << (passed ? "PASS" : "FAIL") << "] " << testName << endl;
+}
+
+// 测试1: 基本的put和get功能
+bool testBasicPutGet() {
+    TinyLfuCache<int, string> cache(3);
+
+    string value;
+    if (cache.get(1, value)) return false;
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.put(3, "three");
+
+    if (!cache.get(1, value) || value != "one") return false;
+    if (!cache.get(2, value) || value != "two") return false;
+    if (!cache.get(3, value) || value != "three") return false;
+    if (cache.get(4, value)) return false;
+
+    // 更新已存在的key
+    cache.put(2, "TWO");
+    if (cache.get(2) != "TWO") return false;
+
+    // tryEmplace不覆盖已存在的key，remove后可以重新插入
+    if (cache.tryEmplace(2, "two") || cache.get(2) != "TWO") return false;
+    cache.remove(2);
+    if (cache.get(2, value)) return false;
+    return cache.tryEmplace(2, "two") && cache.get(2) == "two";
+}
+
+// 测试2: 零容量与容量边界：条目数不超过容量
+bool testCapacityBound() {
+    TinyLfuCache<int, int> empty(0);
+    empty.put(1, 1);
+    int value;
+    if (empty.get(1, value)) return false;
+
+    TinyLfuCache<int, int> one(1);
+    one.put(1, 1);
+    if (!one.get(1, value) || value != 1) return false;
+
+    TinyLfuCache<int, int> cache(100);
+    mt19937 gen(1);
+    for (int i = 0; i < 20000; ++i) {
+        int key = gen() % 1000;
+        if (!cache.get(key, value)) cache.put(key, key);
+        if (cache.size() > 100) return false;
+    }
+    return cache.size() == 100;
+}
+
+// 测试3: 频次统计：反复访问的key估算频次更高，计数器有上限且会周期性减半
+bool testFrequencySketch() {
+    TinyLfuCache<int, int> cache(64);
+    for (int i = 0; i < 64; ++i) cache.put(i, i);
+
+    int value;
+    for (int round = 0; round < 10; ++round) {
+        cache.get(1, value);
+    }
+    if (cache.frequency(1) < 8 || cache.frequency(2) > 2) return false;
+    if (cache.frequency(100000) != 0) return false;
+
+    // 大量访问其他key之后，采样窗口到期减半，key=1的频次随之衰减
+    int before = cache.frequency(1);
+    for (int i = 0; i < 5000; ++i) {
+        cache.get(i % 64 + 2, value);
+    }
+    return cache.frequency(1) < before;
+}
+
+// 测试3b: 每次记录都计入采样窗口，门卫插入也算：大量只出现一次的key不会把门卫填满
+bool testDoorkeeperReset() {
+    const int capacity = 100;
+    TinyLfuCache<int, int> cache(capacity);
+    for (int i = 0; i < 50 * capacity; ++i) {
+        cache.put(i, i);
+    }
+    return cache.frequency(-1) == 0 && cache.frequency(50 * capacity + 1) == 0;
+}
+
+// 测试4: 准入策略：一次性访问的大量key不会挤掉热点，同样的访问序列下LRU会被冲掉
+bool testScanResistance() {
+    TinyLfuCache<int, int> tinyLfu(100);
+    LRUCache<int, int> lru(100);
+    int value;
+
+    for (int round = 0; round < 20; ++round) {
+        for (int key = 0; key < 50; ++key) {
+            if (!tinyLfu.get(key, value)) tinyLfu.put(key, key);
+            if (!lru.get(key, value)) lru.put(key, key);
+        }
+    }
+    // 一次大范围扫描，每个key只访问一次
+    for (int key = 100000; key < 101000; ++key) {
+        if (!tinyLfu.get(key, value)) tinyLfu.put(key, key);
+        if (!lru.get(key, value)) lru.put(key, key);
+    }
+
+    int tinyLfuSurvived = 0;
+    int lruSurvived = 0;
+    for (int key = 0; key < 50; ++key) {
+        if (tinyLfu.get(key, value)) tinyLfuSurvived++;
+        if (lru.get(key, value)) lruSurvived++;
+    }
+    return tinyLfuSurvived >= 45 && lruSurvived == 0;
+}
+
+// 测试5: 新的热点最终能进入主区
+bool testNewHotKeyAdmitted() {
+    TinyLfuCache<int, int> cache(50);
+    int value;
+    for (int round = 0; round < 5; ++round) {
+        for (int key = 0; key < 50; ++key) {
+            if (!cache.get(key, value)) cache.put(key, key);
+        }
+    }
+
+    // key=1000反复被请求，每次未命中后写入，频次累积到超过主区的淘汰者后被接纳
+    for (int i = 0; i < 30; ++i) {
+        if (!cache.get(1000, value)) cache.put(1000, 1000);
+        cache.put(2000 + i, i); // 挤出窗口
+    }
+    return cache.get(1000, value) && value == 1000;
+}
+
+// 测试6: 多线程安全性
+bool testThreadSafety() {
+    TinyLfuCache<int, string> cache(200);
+    const int numThreads = 8;
+    atomic<bool> testPassed{true};
+    vector<thread> threads;
+
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            mt19937 gen(t);
+            for (int i = 0; i < 5000; ++i) {
+                int key = gen() % 400;
+                if (i % 5 == 0) {
+                    cache.put(key, to_string(key));
+                } else if (i % 97 == 0) {
+                    cache.remove(key);
+                } else {
+                    string value;
+                    if (cache.get(key, value) && value != to_string(key)) {
+                        testPassed = false;
+                    }
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return testPassed.load() && cache.size() <= 200;
+}
+
+int main() {
+    cout << "开始W-TinyLFU缓存测试..." << endl;
+    cout << "=========================" << endl;
+
+    vector<pair<string, function<bool()>>> tests = {
+        {"基本Put/Get功能", testBasicPutGet},
+        {"容量边界", testCapacityBound},
+        {"Count-Min频次统计", testFrequencySketch},
+        {"门卫按采样窗口清空", testDoorkeeperReset},
+        {"扫描抵抗", testScanResistance},
+        {"新热点准入", testNewHotKeyAdmitted},
+        {"多线程安全", testThreadSafety}
+    };
+
+    int passedTests = 0;
+    int totalTests = tests.size();
+
+    for (const auto& test : tests) {
+        try {
+            auto start = chrono::high_resolution_clock::now();
+            bool result = test.second();
+            auto end = chrono::high_resolution_clock::now();
+            auto duration = chrono::duration_cast<chrono::milliseconds>(end - start);
+
+            printTestResult(test.first + " (" + to_string(duration.count()) + "ms)", result);
+            if (result) passedTests++;
+        } catch (const exception& e) {
+            printTestResult(test.first + " (异常: " + e.what() + ")", false);
+        } catch (...) {
+            printTestResult(test.first + " (未知异常)", false);
+        }
+    }
+
+    cout << "\n=========================" << endl;
+    cout << "测试结果: " << passedTests << "/" << totalTests << " 通过" << endl;
+
+    if (passedTests == totalTests) {
+        cout << "所有测试通过! ✓" << endl;
+    } else {
+        cout << "有 " << (totalTests - passedTests) << " 个测试失败! ✗" << endl;
+    }
+
+    return passedTests == totalTests ? 0 : 1;
+}
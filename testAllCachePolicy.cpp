@@ -5,11 +5,16 @@
 #include <iomanip>
 #include <random>
 #include <algorithm>
+#include <array>
 
 #include "CachePolicy.h"
 #include "LFUCache.h"
 #include "LRUCache.h"
+#include "SlabLruCache.h"
+#include "ClockCache.h"
+#include "TinyLfuCache.h"
 #include "ArcCache/ArcCache.h"
+#include "bench/LatencyHistogram.h"
 
 using namespace std;
 using namespace Cache;
@@ -18,31 +23,29 @@ class Timer {
 public:
     Timer() : start_(chrono::high_resolution_clock::now()) {}
     
+    // 返回经过的毫秒数(保留小数)
     double elapsed() {
         auto now = chrono::high_resolution_clock::now();
-        return chrono::duration_cast<chrono::milliseconds>(now - start_).count();
+        return chrono::duration<double, milli>(now - start_).count();
     }
 
 private:
     chrono::time_point<chrono::high_resolution_clock> start_;
 };
 
+// 参与对比的算法名称，顺序与各测试场景中caches数组一致
+const vector<string> kPolicyNames = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging", "LRU-Slab", "CLOCK", "CLOCK-Pro", "W-TinyLFU", "ARC-Canonical"};
+
 // 辅助函数：打印结果
-void printResults(const string& testName, int capacity, 
+void printResults(const string& testName, int capacity, int operations,
                  const vector<int>& get_operations, 
-                 const vector<int>& hits) {
+                 const vector<int>& hits,
+                 const vector<double>& elapsedMs,
+                 const vector<Bench::OpLatency>& latency) {
     cout << "=== " << testName << " 结果汇总 ===" << std::endl;
     cout << "缓存大小: " << capacity << std::endl;
     
-    // 对应的算法名称已在测试函数中定义
-    vector<string> names;
-    if (hits.size() == 3) {
-        names = {"LRU", "LFU", "ARC"};
-    } else if (hits.size() == 4) {
-        names = {"LRU", "LFU", "ARC", "LRU-K"};
-    } else if (hits.size() == 5) {
-        names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
-    }
+    const vector<string>& names = kPolicyNames;
     
     for (size_t i = 0; i < hits.size(); ++i) {
         double hitRate = 100.0 * hits[i] / get_operations[i];
@@ -50,7 +53,16 @@ void printResults(const string& testName, int capacity,
                   << " - 命中率: " << fixed << setprecision(2) 
                   << hitRate << "% ";
         // 添加具体命中次数和总操作次数
-        cout << "(" << hits[i] << "/" << get_operations[i] << ")" << endl;
+        cout << "(" << hits[i] << "/" << get_operations[i] << ")";
+        // 吞吐量：该策略完成全部操作的速度
+        cout << " 吞吐量: " << setprecision(0) << operations / (elapsedMs[i] / 1000.0) << " ops/sec" << endl;
+    }
+
+    // 每次get/put的延迟分布
+    cout << endl;
+    Bench::printLatencyHeader(cout);
+    for (size_t i = 0; i < latency.size(); ++i) {
+        Bench::printLatencyRows(cout, i < names.size() ? names[i] : "Algorithm " + to_string(i+1), latency[i]);
     }
     
     cout << endl;  // 添加空行，使输出更清晰
@@ -70,13 +82,20 @@ void testHotDataAccess() {
     ArcCache<int, string> arc(CAPACITY);
     KLruKCache<int, string> lruk(CAPACITY, HOT_KEYS + MID_KEYS + COLD_KEYS, 2);
     LFUCache<int, string> lfuAging(CAPACITY, 20000);
+    SlabLruCache<int, string> lruSlab(CAPACITY);
+    ClockCache<int, string> clock(CAPACITY);
+    ClockProCache<int, string> clockPro(CAPACITY);
+    TinyLfuCache<int, string> tinyLfu(CAPACITY);
+    ArcCache<int, string> arcCanonical(CAPACITY, 2, ArcMode::Canonical);
 
     random_device rd;
     mt19937 gen(rd());
 
-    array<CachePolicy<int, string>*, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    vector<int> hits(5, 0);
-    vector<int> get_operations(5, 0);
+    array<CachePolicy<int, string>*, 10> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lruSlab, &clock, &clockPro, &tinyLfu, &arcCanonical};
+    vector<int> hits(caches.size(), 0);
+    vector<int> get_operations(caches.size(), 0);
+    vector<double> elapsedMs(caches.size(), 0);
+    vector<Bench::OpLatency> latency(caches.size());
 
     for (int i = 0; i < caches.size(); ++i) {
         for (int key = 0; key < HOT_KEYS; ++key) {
@@ -84,6 +103,7 @@ void testHotDataAccess() {
             caches[i]->put(key, value);
         }
 
+        Timer timer;
         for (int op = 0; op < OPERATIONS; ++op) {
             bool isPut = (gen() % 100 < 20); // 降低写操作比例
             int key;
@@ -98,18 +118,24 @@ void testHotDataAccess() {
 
             if (isPut) {
                 string value = "value" + to_string(key) + "_v" + to_string(op % 100);
+                uint64_t start = Bench::TickClock::now();
                 caches[i]->put(key, value);
+                latency[i].put.recordSince(start);
             } else {
                 string result;
                 get_operations[i]++;
-                if (caches[i]->get(key, result)) {
+                uint64_t start = Bench::TickClock::now();
+                bool hit = caches[i]->get(key, result);
+                latency[i].get.recordSince(start);
+                if (hit) {
                     hits[i]++;
                 }
             }
         }
+        elapsedMs[i] = timer.elapsed();
     }
 
-    printResults("热点数据访问测试（优化版）", CAPACITY, get_operations, hits);
+    printResults("热点数据访问测试（优化版）", CAPACITY, OPERATIONS, get_operations, hits, elapsedMs, latency);
 }
 
 void testLoopPattern() {
@@ -125,11 +151,17 @@ void testLoopPattern() {
     ArcCache<int, string> arc(CAPACITY);
     KLruKCache<int, string> lruk(CAPACITY, LOOP_SIZE * 2, 2);
     LFUCache<int, string> lfuAging(CAPACITY, 3000);
-
-    array<CachePolicy<int, string>*, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    vector<int> hits(5, 0);
-    vector<int> get_operations(5, 0);
-    vector<string> names = {"LRU", "LFU", "ARC", "LRU-K", "LFU-Aging"};
+    SlabLruCache<int, string> lruSlab(CAPACITY);
+    ClockCache<int, string> clock(CAPACITY);
+    ClockProCache<int, string> clockPro(CAPACITY);
+    TinyLfuCache<int, string> tinyLfu(CAPACITY);
+    ArcCache<int, string> arcCanonical(CAPACITY, 2, ArcMode::Canonical);
+
+    array<CachePolicy<int, string>*, 10> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lruSlab, &clock, &clockPro, &tinyLfu, &arcCanonical};
+    vector<int> hits(caches.size(), 0);
+    vector<int> get_operations(caches.size(), 0);
+    vector<double> elapsedMs(caches.size(), 0);
+    vector<Bench::OpLatency> latency(caches.size());
 
     random_device rd;
     mt19937 gen(rd());
@@ -143,6 +175,7 @@ void testLoopPattern() {
 
         int current_pos = 0;
 
+        Timer timer;
         for (int op = 0; op < OPERATIONS; ++op) {
             // 10%写操作，90%读操作
             bool isPut = (gen() % 100 < 10);
@@ -161,18 +194,24 @@ void testLoopPattern() {
 
             if (isPut) {
                 string value = "loop" + to_string(key) + "_v" + to_string(op % 100);
+                uint64_t start = Bench::TickClock::now();
                 caches[i]->put(key, value);
+                latency[i].put.recordSince(start);
             } else {
                 string result;
                 get_operations[i]++;
-                if (caches[i]->get(key, result)) {
+                uint64_t start = Bench::TickClock::now();
+                bool hit = caches[i]->get(key, result);
+                latency[i].get.recordSince(start);
+                if (hit) {
                     hits[i]++;
                 }
             }
         }
+        elapsedMs[i] = timer.elapsed();
     }
 
-    printResults("循环扫描测试（优化版）", CAPACITY, get_operations, hits);
+    printResults("循环扫描测试（优化版）", CAPACITY, OPERATIONS, get_operations, hits, elapsedMs, latency);
 }
 
 void testWorkloadShift() {
@@ -187,12 +226,19 @@ void testWorkloadShift() {
     ArcCache<int, string> arc(CAPACITY);
     KLruKCache<int, string> lruk(CAPACITY, 500, 2);
     LFUCache<int, string> lfuAging(CAPACITY, 10000);
+    SlabLruCache<int, string> lruSlab(CAPACITY);
+    ClockCache<int, string> clock(CAPACITY);
+    ClockProCache<int, string> clockPro(CAPACITY);
+    TinyLfuCache<int, string> tinyLfu(CAPACITY);
+    ArcCache<int, string> arcCanonical(CAPACITY, 2, ArcMode::Canonical);
 
     random_device rd;
     mt19937 gen(rd());
-    array<CachePolicy<int, string>*, 5> caches = {&lru, &lfu, &arc, &lruk, &lfuAging};
-    vector<int> hits(5, 0);
-    vector<int> get_operations(5, 0);
+    array<CachePolicy<int, string>*, 10> caches = {&lru, &lfu, &arc, &lruk, &lfuAging, &lruSlab, &clock, &clockPro, &tinyLfu, &arcCanonical};
+    vector<int> hits(caches.size(), 0);
+    vector<int> get_operations(caches.size(), 0);
+    vector<double> elapsedMs(caches.size(), 0);
+    vector<Bench::OpLatency> latency(caches.size());
 
     for (int i = 0; i < caches.size(); ++i) {
         for (int key = 0; key < 30; ++key) {
@@ -200,6 +246,7 @@ void testWorkloadShift() {
             caches[i]->put(key, value);
         }
 
+        Timer timer;
         for (int op = 0; op < OPERATIONS; ++op) {
             int phase = op / PHASE_LENGTH;
             int putProbability;
@@ -234,18 +281,24 @@ void testWorkloadShift() {
 
             if (isPut) {
                 string value = "value" + to_string(key) + "_p" + to_string(phase);
+                uint64_t start = Bench::TickClock::now();
                 caches[i]->put(key, value);
+                latency[i].put.recordSince(start);
             } else {
                 string result;
                 get_operations[i]++;
-                if (caches[i]->get(key, result)) {
+                uint64_t start = Bench::TickClock::now();
+                bool hit = caches[i]->get(key, result);
+                latency[i].get.recordSince(start);
+                if (hit) {
                     hits[i]++;
                 }
             }
         }
+        elapsedMs[i] = timer.elapsed();
     }
 
-    printResults("工作负载剧烈变化测试（优化版）", CAPACITY, get_operations, hits);
+    printResults("工作负载剧烈变化测试（优化版）", CAPACITY, OPERATIONS, get_operations, hits, elapsedMs, latency);
 }
 
 int main() {